@@ -14,6 +14,10 @@
  */
 
 #include <qxml.h>
+#include <qbuffer.h>
+#include <qdatastream.h>
+#include <qdatetime.h>
+#include <qdir.h>
 #include "mainhandler.h"
 #include "compoundhandler.h"
 #include "sectionhandler.h"
@@ -111,12 +115,57 @@ MainHandler::~MainHandler()
   debug(2,"MainHandler::~MainHandler()\n");
 }
 
+CompoundEntry *MainHandler::addCompound(const QString &id)
+{
+  CompoundEntry *ce = new CompoundEntry(257);
+  ce->id = id;
+  m_compounds.append(ce);
+  m_compoundDict.insert(ce->id.utf8(),ce);
+  return ce;
+}
+
+void MainHandler::setCompoundName(CompoundEntry *ce,const QString &name)
+{
+  ce->name = name;
+  m_compoundNameDict.insert(name.utf8(),ce);
+}
+
+MemberEntry *MainHandler::addMember(CompoundEntry *ce,const QString &id)
+{
+  MemberEntry *me = new MemberEntry;
+  me->id = id;
+  me->compound = ce;
+  m_memberDict.insert(me->id.utf8(),me);
+  return me;
+}
+
+void MainHandler::setMemberName(MemberEntry *me,const QString &name)
+{
+  me->name = name;
+  CompoundEntry *ce = me->compound;
+  ce->memberDict.insert(me->name.utf8(),me);
+  ce->memberList.append(me);
+  QList<CompoundEntry> *cel=0;
+  if ((cel=m_memberNameDict.find(me->name.utf8()))==0)
+  {
+    cel = new QList<CompoundEntry>;
+    m_memberNameDict.insert(me->name.utf8(),cel);
+  }
+  cel->append(ce);
+}
+
+void MainHandler::clearIndex()
+{
+  m_memberNameDict.clear();
+  m_memberDict.clear();
+  m_compoundNameDict.clear();
+  m_compoundDict.clear();
+  m_compounds.clear();
+}
+
 void MainHandler::startCompound(const QXmlAttributes& attrib)
 {
-  m_curCompound = new CompoundEntry(257);
-  m_curCompound->id = attrib.value("refid");
-  m_compounds.append(m_curCompound);
-  m_compoundDict.insert(m_curCompound->id.utf8(),m_curCompound);
+  m_curCompound = addCompound(attrib.value("refid"));
 }
 
 void MainHandler::startName(const QXmlAttributes& /*attrib*/)
@@ -132,31 +181,135 @@ void MainHandler::endName()
   }
   else
   {
-    m_curCompound->name = m_curString;
-    m_compoundNameDict.insert(m_curString.utf8(),m_curCompound);
+    setCompoundName(m_curCompound,m_curString);
   }
 }
 
 void MainHandler::startMember(const QXmlAttributes& attrib)
 {
   m_insideMember = TRUE;
-  m_curMember = new MemberEntry;
-  m_curMember->id = attrib.value("refid");
-  m_curMember->compound = m_curCompound;
-  m_memberDict.insert(m_curMember->id.utf8(),m_curMember);
+  m_curMember = addMember(m_curCompound,attrib.value("refid"));
 }
 
 void MainHandler::endMember()
 {
-  m_curCompound->memberDict.insert(m_curMember->name.utf8(),m_curMember);
-  QList<CompoundEntry> *cel=0;
-  if ((cel=m_memberNameDict.find(m_curMember->name.utf8()))==0)
+  setMemberName(m_curMember,m_curMember->name);
+  m_insideMember = FALSE;
+}
+
+//--------------------------------------------------------------------------
+
+// The contents of index.xml are stored in a binary file next to it, so
+// later runs, also of other processes, can skip parsing the XML. The file
+// is only used if index.xml has the same size, time stamp and checksum
+// as when the cache was written. The time stamp only has a resolution of
+// a second, so it is the checksum that detects a rewrite within the same 
+// second that keeps the size.
+
+#define INDEXCACHE_NAME    "index.cache"
+#define INDEXCACHE_MAGIC   0x44584958 // "DXIX"
+#define INDEXCACHE_VERSION 2
+
+static Q_UINT32 indexTimeStamp(const QFileInfo &fi)
+{
+  QDateTime epoch;
+  epoch.setTime_t(0);
+  return (Q_UINT32)epoch.secsTo(fi.lastModified());
+}
+
+/** Returns the FNV-1a hash of the contents of \a fileName. */
+static Q_UINT32 indexChecksum(const QString &fileName)
+{
+  Q_UINT32 h = 2166136261u;
+  QFile f(fileName);
+  if (f.open(IO_ReadOnly))
   {
-    cel = new QList<CompoundEntry>;
-    m_memberNameDict.insert(m_curMember->name.utf8(),cel);
+    char buf[65536];
+    int n,i;
+    while ((n=f.readBlock(buf,sizeof(buf)))>0)
+    {
+      for (i=0;i<n;i++) { h^=(uchar)buf[i]; h*=16777619u; }
+    }
+  }
+  return h;
+}
+
+bool MainHandler::readIndexCache(const QFileInfo &fi,Q_UINT32 checksum)
+{
+  QFile f(m_xmlDirName+"/"+INDEXCACHE_NAME);
+  if (!f.open(IO_ReadOnly)) return FALSE;
+  QByteArray data = f.readAll();
+  f.close();
+  QBuffer buf(data);
+  buf.open(IO_ReadOnly);
+  QDataStream s(&buf);
+  Q_UINT32 magic=0,version=0,size=0,timeStamp=0,sum=0,numCompounds=0;
+  s >> magic >> version;
+  if (magic!=INDEXCACHE_MAGIC || version!=INDEXCACHE_VERSION) return FALSE;
+  s >> size >> timeStamp >> sum >> numCompounds;
+  if (size!=(Q_UINT32)fi.size() || timeStamp!=indexTimeStamp(fi) || sum!=checksum)
+  {
+    return FALSE;
+  }
+  debug(2,"reading %d compounds from %s\n",numCompounds,INDEXCACHE_NAME);
+  Q_UINT32 i,j;
+  for (i=0;i<numCompounds && !s.atEnd();i++)
+  {
+    QString id,name;
+    Q_UINT32 numMembers=0;
+    s >> id >> name >> numMembers;
+    CompoundEntry *ce = addCompound(id);
+    setCompoundName(ce,name);
+    for (j=0;j<numMembers && !s.atEnd();j++)
+    {
+      s >> id >> name;
+      setMemberName(addMember(ce,id),name);
+    }
+    if (j<numMembers) break;
+  }
+  Q_UINT32 endMagic=0;
+  if (i==numCompounds && !s.atEnd()) s >> endMagic;
+  if (endMagic!=INDEXCACHE_MAGIC) // truncated or corrupt cache
+  {
+    clearIndex();
+    return FALSE;
+  }
+  return TRUE;
+}
+
+void MainHandler::writeIndexCache(const QFileInfo &fi,Q_UINT32 checksum)
+{
+  // write to a temporary file first, so other processes never see a
+  // partially written cache
+  QString fileName = m_xmlDirName+"/"+INDEXCACHE_NAME;
+  QFile f(fileName+".tmp");
+  if (!f.open(IO_WriteOnly)) return; // not fatal, e.g. read-only directory
+  {
+    QDataStream s(&f);
+    s << (Q_UINT32)INDEXCACHE_MAGIC << (Q_UINT32)INDEXCACHE_VERSION
+      << (Q_UINT32)fi.size() << indexTimeStamp(fi) << checksum
+      << (Q_UINT32)m_compounds.count();
+    QListIterator<CompoundEntry> cli(m_compounds);
+    CompoundEntry *ce;
+    for (cli.toFirst();(ce=cli.current());++cli)
+    {
+      s << ce->id << ce->name << (Q_UINT32)ce->memberList.count();
+      QListIterator<MemberEntry> mli(ce->memberList);
+      MemberEntry *me;
+      for (mli.toFirst();(me=mli.current());++mli)
+      {
+        s << me->id << me->name;
+      }
+    }
+    s << (Q_UINT32)INDEXCACHE_MAGIC;
+  }
+  f.close();
+  QDir dir(m_xmlDirName);
+  dir.remove(INDEXCACHE_NAME);
+  if (!dir.rename(QString(INDEXCACHE_NAME)+".tmp",INDEXCACHE_NAME))
+  {
+    dir.remove(QString(INDEXCACHE_NAME)+".tmp");
   }
-  cel->append(m_curCompound);
-  m_insideMember = FALSE;
 }
 
 void MainHandler::setDebugLevel(int level)
@@ -171,9 +324,9 @@ void MainHandler::dump()
   for (cli.toFirst();(ce=cli.current());++cli)
   {
     debug(2,"compound id=`%s' name=`%s'\n",ce->id.data(),ce->name.data());
-    QDictIterator<MemberEntry> mdi(ce->memberDict);
+    QListIterator<MemberEntry> mli(ce->memberList);
     MemberEntry *me;
-    for (mdi.toFirst();(me=mdi.current());++mdi)
+    for (mli.toFirst();(me=mli.current());++mli)
     {
       debug(2,"  member id=`%s' name=`%s'\n",me->id.data(),me->name.data());
     }
@@ -189,12 +342,20 @@ bool MainHandler::readXMLDir(const char * xmlDirName)
   //    xmlFileName.data(),xmlFile.exists(),xmlFile.isReadable());
   if (xmlFile.exists())
   {
-    ErrorHandler errorHandler;
-    QXmlInputSource source( xmlFile );
-    QXmlSimpleReader reader;
-    reader.setContentHandler( this );
-    reader.setErrorHandler( &errorHandler );
-    reader.parse( source );
+    QFileInfo fi(xmlFile);
+    Q_UINT32 checksum = indexChecksum(xmlFileName);
+    if (!readIndexCache(fi,checksum))
+    {
+      ErrorHandler errorHandler;
+      QXmlInputSource source( xmlFile );
+      QXmlSimpleReader reader;
+      reader.setContentHandler( this );
+      reader.setErrorHandler( &errorHandler );
+      if (reader.parse( source ))
+      {
+        writeIndexCache(fi,checksum);
+      }
+    }
     dump();
     return TRUE;
   }
@@ -17,6 +17,7 @@
 #define _MAINHANDLER_H
 
 #include <qlist.h>
+#include <qfileinfo.h>
 
 #include <doxmlintf.h>
 #include "basehandler.h"
@@ -40,6 +41,7 @@ struct CompoundEntry : public IndexEntry
     CompoundEntry(int size) : memberDict(size) 
     { memberDict.setAutoDelete(TRUE); }
     QDict<MemberEntry> memberDict;
+    QList<MemberEntry> memberList; // in document order, owned by memberDict
 };
 
 class MainHandler : public IDoxygen, public BaseHandler<MainHandler>
@@ -67,6 +69,14 @@ class MainHandler : public IDoxygen, public BaseHandler<MainHandler>
     void unloadCompound(CompoundHandler *ch);
 
   private:
+    CompoundEntry *addCompound(const QString &id);
+    void setCompoundName(CompoundEntry *ce,const QString &name);
+    MemberEntry *addMember(CompoundEntry *ce,const QString &id);
+    void setMemberName(MemberEntry *me,const QString &name);
+    void clearIndex();
+    bool readIndexCache(const QFileInfo &fi,Q_UINT32 checksum);
+    void writeIndexCache(const QFileInfo &fi,Q_UINT32 checksum);
+
     CompoundEntry               *m_curCompound;
     MemberEntry                 *m_curMember;
     QList<CompoundEntry>         m_compounds;
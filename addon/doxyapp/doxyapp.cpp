@@ -23,6 +23,10 @@
  *  This example shows how to use to code parser to get cross-references information
  *  and it also shows how to look up symbols in a program parsed by doxygen and
  *  show some information about them.
+ *
+ *  Finally it shows how to use the QueryModel to find callers, members of a
+ *  certain type and inheritance relations, and how to save the model so a
+ *  later run can answer these queries without parsing the sources again.
  */
 
 #include <stdlib.h>
@@ -37,6 +41,7 @@
 #include "classlist.h"
 #include "config.h"
 #include "filename.h"
+#include "doxyquery.h"
 
 class XRefDummyCodeGenerator : public CodeOutputInterface
 {
@@ -245,86 +250,198 @@ static void lookupSymbols(const QCString &sym)
   }
 }
 
+static void printQuerySymbols(const QList<QuerySymbol> &list)
+{
+  QListIterator<QuerySymbol> li(list);
+  QuerySymbol *s;
+  for (li.toFirst();(s=li.current());++li)
+  {
+    printf("%s %s at line %d of %s\n",
+        s->kind().data(),s->name().data(),s->line(),s->fileName().data());
+  }
+  if (list.isEmpty())
+  {
+    printf("Nothing found\n");
+  }
+}
+
+static void queryClassHierarchy(const QueryModel &model,const QCString &name,bool bases)
+{
+  QList<QuerySymbol> result;
+  const QList<QuerySymbol> *list = model.findSymbols(name);
+  if (list)
+  {
+    QListIterator<QuerySymbol> li(*list);
+    QuerySymbol *s;
+    for (li.toFirst();(s=li.current());++li)
+    {
+      if (bases)
+        model.findAllBaseClasses(s,result);
+      else
+        model.findAllSubClasses(s,result);
+    }
+  }
+  printQuerySymbols(result);
+}
+
+static bool runQuery(const QueryModel &model,const QCString &s)
+{
+  int i = s.find(' ');
+  if (s.at(0)!='.' || i==-1) return FALSE;
+  QCString cmd = s.left(i);
+  QCString arg = s.mid(i+1).stripWhiteSpace();
+  if (cmd==".callers")
+  {
+    QList<QuerySymbol> result;
+    model.findCallers(arg,result);
+    printQuerySymbols(result);
+  }
+  else if (cmd==".type")
+  {
+    const QList<QuerySymbol> *list = model.findMembersOfType(arg);
+    printQuerySymbols(list ? *list : QList<QuerySymbol>());
+  }
+  else if (cmd==".bases")
+  {
+    queryClassHierarchy(model,arg,TRUE);
+  }
+  else if (cmd==".derived")
+  {
+    queryClassHierarchy(model,arg,FALSE);
+  }
+  else if (cmd==".save")
+  {
+    if (model.save(arg))
+      printf("Saved %d symbols to %s\n",model.count(),arg.data());
+    else
+      printf("Could not write %s\n",arg.data());
+  }
+  else
+  {
+    return FALSE;
+  }
+  return TRUE;
+}
+
 int main(int argc,char **argv)
 {
   char cmd[256];
+  QueryModel model;
+  bool loaded = FALSE;
 
-  if (argc<2)
+  if (argc<2 || (qstrcmp(argv[1],"-l")==0 && argc<3))
   {
-    printf("Usage: %s [source_file | source_dir]\n",argv[0]);
+    printf("Usage: %s [source_file | source_dir]\n"
+           "       %s -l model_file\n",argv[0],argv[0]);
     exit(1);
   }
 
-  // initialize data structures 
-  initDoxygen();
+  if (qstrcmp(argv[1],"-l")==0) // use a model saved by an earlier run
+  {
+    if (!model.load(argv[2]))
+    {
+      printf("Could not read %s\n",argv[2]);
+      exit(1);
+    }
+    loaded = TRUE;
+  }
+  else
+  {
+    // initialize data structures 
+    initDoxygen();
 
-  // setup the non-default configuration options
+    // setup the non-default configuration options
 
-  // we need a place to put intermediate files
-  Config_getString("OUTPUT_DIRECTORY")="/tmp/doxygen"; 
-  // disable html output
-  Config_getBool("GENERATE_HTML")=FALSE;
-  // disable latex output
-  Config_getBool("GENERATE_LATEX")=FALSE;
-  // be quiet
-  Config_getBool("QUIET")=TRUE;
-  // turn off warnings
-  Config_getBool("WARNINGS")=FALSE;
-  Config_getBool("WARN_IF_UNDOCUMENTED")=FALSE;
-  Config_getBool("WARN_IF_DOC_ERROR")=FALSE;
-  // Extract as much as possible
-  Config_getBool("EXTRACT_ALL")=TRUE;
-  Config_getBool("EXTRACT_STATIC")=TRUE;
-  Config_getBool("EXTRACT_PRIVATE")=TRUE;
-  Config_getBool("EXTRACT_LOCAL_METHODS")=TRUE;
-  // Extract source browse information, needed 
-  // to make doxygen gather the cross reference info
-  Config_getBool("SOURCE_BROWSER")=TRUE;
+    // we need a place to put intermediate files
+    Config_getString("OUTPUT_DIRECTORY")="/tmp/doxygen"; 
+    // disable html output
+    Config_getBool("GENERATE_HTML")=FALSE;
+    // disable latex output
+    Config_getBool("GENERATE_LATEX")=FALSE;
+    // be quiet
+    Config_getBool("QUIET")=TRUE;
+    // turn off warnings
+    Config_getBool("WARNINGS")=FALSE;
+    Config_getBool("WARN_IF_UNDOCUMENTED")=FALSE;
+    Config_getBool("WARN_IF_DOC_ERROR")=FALSE;
+    // Extract as much as possible
+    Config_getBool("EXTRACT_ALL")=TRUE;
+    Config_getBool("EXTRACT_STATIC")=TRUE;
+    Config_getBool("EXTRACT_PRIVATE")=TRUE;
+    Config_getBool("EXTRACT_LOCAL_METHODS")=TRUE;
+    // Extract source browse information, needed 
+    // to make doxygen gather the cross reference info
+    Config_getBool("SOURCE_BROWSER")=TRUE;
+    // record which members are used by each member, needed for
+    // the .callers query
+    Config_getBool("REFERENCES_RELATION")=TRUE;
 
-  // set the input
-  Config_getList("INPUT").append(argv[1]);
+    // set the input
+    Config_getList("INPUT").append(argv[1]);
 
-  // check and finialize the configuration
-  checkConfiguration();
-  adjustConfiguration();
+    // check and finialize the configuration
+    checkConfiguration();
+    adjustConfiguration();
 
-  // parse the files
-  parseInput();
+    // parse the files
+    parseInput();
 
-  // iterate over the input files
-  FileNameListIterator fnli(*Doxygen::inputNameList); 
-  FileName *fn;
-  // foreach file with a certain name
-  for (fnli.toFirst();(fn=fnli.current());++fnli)
-  {
-    FileNameIterator fni(*fn);
-    FileDef *fd;
-    // for each file definition
-    for (;(fd=fni.current());++fni)
+    // iterate over the input files
+    FileNameListIterator fnli(*Doxygen::inputNameList); 
+    FileName *fn;
+    // foreach file with a certain name
+    for (fnli.toFirst();(fn=fnli.current());++fnli)
     {
-      // get the references (linked and unlinked) found in this file
-      findXRefSymbols(fd);
+      FileNameIterator fni(*fn);
+      FileDef *fd;
+      // for each file definition
+      for (;(fd=fni.current());++fni)
+      {
+        // get the references (linked and unlinked) found in this file
+        findXRefSymbols(fd);
+      }
     }
-  }
 
-  // remove temporary files
-  if (!Doxygen::objDBFileName.isEmpty()) unlink(Doxygen::objDBFileName);
-  if (!Doxygen::entryDBFileName.isEmpty()) unlink(Doxygen::entryDBFileName);
-  // clean up after us
-  rmdir("/tmp/doxygen");
+    // build the indexes used for the queries
+    model.build();
+
+    // remove temporary files
+    if (!Doxygen::objDBFileName.isEmpty()) unlink(Doxygen::objDBFileName);
+    if (!Doxygen::entryDBFileName.isEmpty()) unlink(Doxygen::entryDBFileName);
+    // clean up after us
+    rmdir("/tmp/doxygen");
+  }
 
   while (1)
   {
-    printf("> Type a symbol name or\n> .list for a list of symbols or\n> .quit to exit\n> ");
-    fgets(cmd,256,stdin);
+    printf("> Type a symbol name or\n"
+           "> .list for a list of symbols or\n"
+           "> .callers <name> for the members using <name> or\n"
+           "> .type <type> for the members using type <type> or\n"
+           "> .bases <class> or .derived <class> for the class hierarchy or\n"
+           "> .save <file> to save the symbols for use with -l or\n"
+           "> .quit to exit\n> ");
+    if (fgets(cmd,256,stdin)==0) exit(0);
     QCString s(cmd);
     if (s.at(s.length()-1)=='\n') s=s.left(s.length()-1); // strip trailing \n
     if (s==".list") 
-      listSymbols();
+    {
+      if (loaded)
+        printQuerySymbols(model.symbols());
+      else
+        listSymbols();
+    }
     else if (s==".quit") 
       exit(0);
-    else 
-      lookupSymbols(s);
+    else if (!runQuery(model,s))
+    {
+      if (loaded)
+      {
+        const QList<QuerySymbol> *list = model.findSymbols(s);
+        printQuerySymbols(list ? *list : QList<QuerySymbol>());
+      }
+      else
+        lookupSymbols(s);
+    }
   }
 }
-
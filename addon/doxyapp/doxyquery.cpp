@@ -0,0 +1,453 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2015 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#include <ctype.h>
+#include <qfile.h>
+#include <qbuffer.h>
+#include <qdatastream.h>
+#include <qptrdict.h>
+#include <qintdict.h>
+#include <qstrlist.h>
+
+#include "doxyquery.h"
+#include "doxygen.h"
+#include "classdef.h"
+#include "classlist.h"
+#include "namespacedef.h"
+#include "filedef.h"
+#include "filename.h"
+#include "memberdef.h"
+#include "membername.h"
+#include "memberlist.h"
+
+#define QUERYMODEL_MAGIC   0x44585152 // "DXQR"
+#define QUERYMODEL_VERSION 1
+
+//----------------------------------------------------------------------------
+
+/** Adds each name used in the type \a type that is not a C/C++ keyword
+ *  to \a names, so "const std::vector<Foo> &" yields std::vector and Foo.
+ */
+static void getTypeNames(const QCString &type,QStrList &names)
+{
+  static const char *skip[] = { "const", "volatile", "static", "inline",
+    "virtual", "explicit", "mutable", "extern", "unsigned", "signed",
+    "struct", "class", "union", "enum", "typename", 0 };
+  const char *p = type.data();
+  if (p==0) return;
+  while (*p)
+  {
+    if (isalpha((uchar)*p) || *p=='_' || *p==':')
+    {
+      const char *s = p;
+      while (isalnum((uchar)*p) || *p=='_' || *p==':') p++;
+      QCString name(s,p-s+1);
+      while (name.at(0)==':') name=name.mid(1);
+      bool keyword = name.isEmpty();
+      for (int i=0;!keyword && skip[i];i++) keyword = name==skip[i];
+      if (!keyword && names.find(name)==-1) names.append(name);
+    }
+    else
+    {
+      p++;
+    }
+  }
+}
+
+static void writeSymbolList(QDataStream &s,const QList<QuerySymbol> &list)
+{
+  s << (Q_INT32)list.count();
+  QListIterator<QuerySymbol> li(list);
+  QuerySymbol *qs;
+  for (li.toFirst();(qs=li.current());++li)
+  {
+    s << (Q_INT32)qs->id();
+  }
+}
+
+//----------------------------------------------------------------------------
+
+QueryModel::QueryModel() : m_nameIndex(10007), m_typeIndex(1009)
+{
+  m_symbols.setAutoDelete(TRUE);
+  m_nameIndex.setAutoDelete(TRUE);
+  m_typeIndex.setAutoDelete(TRUE);
+}
+
+QueryModel::~QueryModel()
+{
+}
+
+void QueryModel::clear()
+{
+  m_nameIndex.clear();
+  m_typeIndex.clear();
+  m_symbols.clear();
+  m_byId.resize(0);
+}
+
+QuerySymbol *QueryModel::addSymbol(Definition *d)
+{
+  QuerySymbol *s = new QuerySymbol(m_symbols.count());
+  s->m_name      = d->qualifiedName();
+  s->m_localName = d->localName();
+  s->m_fileName  = d->getDefFileName();
+  s->m_line      = d->getDefLine();
+  switch (d->definitionType())
+  {
+    case Definition::TypeClass:
+      s->m_kind = ((ClassDef*)d)->compoundTypeString();
+      break;
+    case Definition::TypeNamespace:
+      s->m_kind = "namespace";
+      break;
+    case Definition::TypeFile:
+      s->m_kind = "file";
+      break;
+    case Definition::TypeMember:
+      {
+        MemberDef *md = (MemberDef*)d;
+        s->m_kind = md->memberTypeName();
+        s->m_type = QCString(md->typeString()).simplifyWhiteSpace();
+      }
+      break;
+    default:
+      break;
+  }
+  m_symbols.append(s);
+  m_byId[s->m_id] = s;
+  return s;
+}
+
+void QueryModel::build()
+{
+  clear();
+  QList<Definition> defs; // the definitions in id order
+
+  // collect the symbols
+  {
+    NamespaceSDict::Iterator nli(*Doxygen::namespaceSDict);
+    NamespaceDef *nd;
+    for (nli.toFirst();(nd=nli.current());++nli)
+    {
+      defs.append(nd);
+    }
+  }
+  {
+    ClassSDict::Iterator cli(*Doxygen::classSDict);
+    ClassDef *cd;
+    for (cli.toFirst();(cd=cli.current());++cli)
+    {
+      defs.append(cd);
+    }
+  }
+  {
+    FileNameListIterator fnli(*Doxygen::inputNameList);
+    FileName *fn;
+    for (fnli.toFirst();(fn=fnli.current());++fnli)
+    {
+      FileNameIterator fni(*fn);
+      FileDef *fd;
+      for (;(fd=fni.current());++fni)
+      {
+        defs.append(fd);
+      }
+    }
+  }
+  MemberNameSDict *memberDicts[] = { Doxygen::memberNameSDict, Doxygen::functionNameSDict };
+  int i;
+  for (i=0;i<2;i++)
+  {
+    MemberNameSDict::Iterator mnli(*memberDicts[i]);
+    MemberName *mn;
+    for (mnli.toFirst();(mn=mnli.current());++mnli)
+    {
+      MemberNameIterator mni(*mn);
+      MemberDef *md;
+      for (;(md=mni.current());++mni)
+      {
+        defs.append(md);
+      }
+    }
+  }
+
+  m_byId.resize(defs.count());
+  QPtrDict<QuerySymbol> defMap(10007);
+  QListIterator<Definition> dli(defs);
+  Definition *d;
+  for (dli.toFirst();(d=dli.current());++dli)
+  {
+    defMap.insert(d,addSymbol(d));
+  }
+
+  // resolve the relations between the symbols in id order, so the
+  // lists are in the same order as after load()
+  for (dli.toFirst(),i=0;(d=dli.current());++dli,i++)
+  {
+    QuerySymbol *s = m_byId[i];
+    s->m_outerScope = defMap.find(d->getOuterScope());
+    if (d->definitionType()==Definition::TypeClass)
+    {
+      BaseClassList *bcl = ((ClassDef*)d)->baseClasses();
+      if (bcl)
+      {
+        BaseClassListIterator bcli(*bcl);
+        BaseClassDef *bcd;
+        for (;(bcd=bcli.current());++bcli)
+        {
+          QuerySymbol *base = defMap.find(bcd->classDef);
+          if (base)
+          {
+            s->m_baseClasses.append(base);
+            base->m_subClasses.append(s);
+          }
+        }
+      }
+    }
+    else if (d->definitionType()==Definition::TypeMember)
+    {
+      MemberSDict *refs = d->getReferencesMembers();
+      if (refs)
+      {
+        MemberSDict::Iterator mi(*refs);
+        MemberDef *md;
+        for (mi.toFirst();(md=mi.current());++mi)
+        {
+          QuerySymbol *ref = defMap.find(md);
+          if (ref)
+          {
+            s->m_references.append(ref);
+            ref->m_referencedBy.append(s);
+          }
+        }
+      }
+    }
+  }
+
+  buildIndexes();
+}
+
+void QueryModel::addToIndex(QDict< QList<QuerySymbol> > &dict,
+                            const QCString &key,QuerySymbol *s)
+{
+  if (key.isEmpty()) return;
+  QList<QuerySymbol> *list = dict.find(key);
+  if (list==0)
+  {
+    list = new QList<QuerySymbol>;
+    dict.insert(key,list);
+  }
+  if (list->getLast()!=s) list->append(s);
+}
+
+void QueryModel::buildIndexes()
+{
+  QListIterator<QuerySymbol> li(m_symbols);
+  QuerySymbol *s;
+  for (li.toFirst();(s=li.current());++li)
+  {
+    addToIndex(m_nameIndex,s->m_name,s);
+    addToIndex(m_nameIndex,s->m_localName,s);
+    if (!s->m_type.isEmpty())
+    {
+      addToIndex(m_typeIndex,s->m_type,s);
+      QStrList names;
+      getTypeNames(s->m_type,names);
+      const char *name;
+      for (name=names.first();name;name=names.next())
+      {
+        addToIndex(m_typeIndex,name,s);
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+
+bool QueryModel::save(const char *fileName) const
+{
+  QFile f(fileName);
+  if (!f.open(IO_WriteOnly)) return FALSE;
+  QDataStream s(&f);
+  s << (Q_INT32)QUERYMODEL_MAGIC << (Q_INT32)QUERYMODEL_VERSION;
+  s << (Q_INT32)m_symbols.count();
+  QListIterator<QuerySymbol> li(m_symbols);
+  QuerySymbol *qs;
+  for (li.toFirst();(qs=li.current());++li)
+  {
+    s << qs->m_name << qs->m_localName << qs->m_kind << qs->m_type
+      << qs->m_fileName << (Q_INT32)qs->m_line
+      << (Q_INT32)(qs->m_outerScope ? qs->m_outerScope->id() : -1);
+  }
+  // the reverse relations are restored while loading
+  for (li.toFirst();(qs=li.current());++li)
+  {
+    writeSymbolList(s,qs->m_references);
+    writeSymbolList(s,qs->m_baseClasses);
+  }
+  s << (Q_INT32)QUERYMODEL_MAGIC;
+  f.close();
+  return f.status()==IO_Ok;
+}
+
+bool QueryModel::load(const char *fileName)
+{
+  clear();
+  QFile f(fileName);
+  if (!f.open(IO_ReadOnly)) return FALSE;
+  QByteArray data = f.readAll();
+  f.close();
+  QBuffer buf(data);
+  buf.open(IO_ReadOnly);
+  QDataStream s(&buf);
+
+  Q_INT32 magic=0,version=0,count=0;
+  s >> magic >> version >> count;
+  if (magic!=QUERYMODEL_MAGIC || version!=QUERYMODEL_VERSION || count<0)
+  {
+    return FALSE;
+  }
+  // symbols are stored in id order, so id and array index are the same
+  m_byId.resize(count);
+  QArray<int> outerIds(count);
+  int i;
+  for (i=0;i<count && !s.atEnd();i++)
+  {
+    QuerySymbol *qs = new QuerySymbol(i);
+    Q_INT32 line,outerId;
+    s >> qs->m_name >> qs->m_localName >> qs->m_kind >> qs->m_type
+      >> qs->m_fileName >> line >> outerId;
+    qs->m_line = line;
+    outerIds[i] = outerId;
+    m_byId[i] = qs;
+    m_symbols.append(qs);
+  }
+  bool ok = i==count;
+  for (i=0;ok && i<count;i++)
+  {
+    QuerySymbol *qs = m_byId[i];
+    if (outerIds[i]>=count) { ok=FALSE; break; }
+    qs->m_outerScope = outerIds[i]>=0 ? m_byId[outerIds[i]] : 0;
+    int r;
+    for (r=0;ok && r<2;r++)
+    {
+      Q_INT32 n=0;
+      s >> n;
+      int j;
+      for (j=0;j<n && !s.atEnd();j++)
+      {
+        Q_INT32 id;
+        s >> id;
+        if (id<0 || id>=count) break;
+        QuerySymbol *other = m_byId[id];
+        if (r==0)
+        {
+          qs->m_references.append(other);
+          other->m_referencedBy.append(qs);
+        }
+        else
+        {
+          qs->m_baseClasses.append(other);
+          other->m_subClasses.append(qs);
+        }
+      }
+      ok = j==n;
+    }
+  }
+  Q_INT32 endMagic=0;
+  if (ok && !s.atEnd()) s >> endMagic;
+  if (endMagic!=QUERYMODEL_MAGIC) // truncated or corrupt file
+  {
+    clear();
+    return FALSE;
+  }
+  buildIndexes();
+  return TRUE;
+}
+
+//----------------------------------------------------------------------------
+
+QuerySymbol *QueryModel::symbol(int id) const
+{
+  return id>=0 && id<(int)m_byId.size() ? m_byId[id] : 0;
+}
+
+const QList<QuerySymbol> *QueryModel::findSymbols(const char *name) const
+{
+  return m_nameIndex.find(name);
+}
+
+const QList<QuerySymbol> *QueryModel::findMembersOfType(const char *type) const
+{
+  return m_typeIndex.find(QCString(type).simplifyWhiteSpace());
+}
+
+void QueryModel::findCallers(const char *name,QList<QuerySymbol> &result) const
+{
+  const QList<QuerySymbol> *list = findSymbols(name);
+  if (list==0) return;
+  QIntDict<char> found(257);
+  QListIterator<QuerySymbol> li(*list);
+  QuerySymbol *s;
+  for (li.toFirst();(s=li.current());++li)
+  {
+    QListIterator<QuerySymbol> ri(s->referencedBy());
+    QuerySymbol *caller;
+    for (ri.toFirst();(caller=ri.current());++ri)
+    {
+      if (found.find(caller->id())==0)
+      {
+        found.insert(caller->id(),(char*)0x8);
+        result.append(caller);
+      }
+    }
+  }
+}
+
+void QueryModel::closure(const QuerySymbol *cls,bool up,
+                         QList<QuerySymbol> &result) const
+{
+  QIntDict<char> visited(257);
+  QList<QuerySymbol> todo;
+  todo.append((QuerySymbol*)cls);
+  visited.insert(cls->id(),(char*)0x8);
+  while (!todo.isEmpty())
+  {
+    QuerySymbol *s = todo.take(0);
+    QListIterator<QuerySymbol> li(up ? s->baseClasses() : s->subClasses());
+    QuerySymbol *next;
+    for (li.toFirst();(next=li.current());++li)
+    {
+      if (visited.find(next->id())==0)
+      {
+        visited.insert(next->id(),(char*)0x8);
+        result.append(next);
+        todo.append(next);
+      }
+    }
+  }
+}
+
+void QueryModel::findAllBaseClasses(const QuerySymbol *cls,
+                                    QList<QuerySymbol> &result) const
+{
+  if (cls) closure(cls,TRUE,result);
+}
+
+void QueryModel::findAllSubClasses(const QuerySymbol *cls,
+                                   QList<QuerySymbol> &result) const
+{
+  if (cls) closure(cls,FALSE,result);
+}
@@ -0,0 +1,141 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2015 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef DOXYQUERY_H
+#define DOXYQUERY_H
+
+#include <qcstring.h>
+#include <qarray.h>
+#include <qlist.h>
+#include <qdict.h>
+
+class QueryModel;
+class Definition;
+
+/** @brief A symbol in the query model.
+ *
+ *  A symbol is a copy of the information doxygen gathered for a class,
+ *  namespace, file or member. It does not refer to doxygen's own
+ *  data structures, so it remains valid after the model is reloaded
+ *  from disk.
+ */
+class QuerySymbol
+{
+  public:
+    /** Unique number of the symbol within its model */
+    int id() const                   { return m_id; }
+    /** Fully qualified name, i.e. A::B::f */
+    const QCString &name() const     { return m_name; }
+    /** Name without the scope */
+    const QCString &localName() const { return m_localName; }
+    /** Kind of symbol, i.e. "class", "namespace", "file", "function" */
+    const QCString &kind() const     { return m_kind; }
+    /** Type of a member, i.e. "const QCString &", empty for other symbols */
+    const QCString &type() const     { return m_type; }
+    /** File in which the symbol is defined */
+    const QCString &fileName() const { return m_fileName; }
+    /** Line at which the symbol is defined */
+    int line() const                 { return m_line; }
+    /** Enclosing class, namespace or file, or 0 for a global symbol */
+    QuerySymbol *outerScope() const  { return m_outerScope; }
+
+    /** Members that this member refers to in its body */
+    const QList<QuerySymbol> &references() const   { return m_references; }
+    /** Members that refer to this member in their bodies */
+    const QList<QuerySymbol> &referencedBy() const { return m_referencedBy; }
+    /** Direct base classes of a class */
+    const QList<QuerySymbol> &baseClasses() const  { return m_baseClasses; }
+    /** Direct sub classes of a class */
+    const QList<QuerySymbol> &subClasses() const   { return m_subClasses; }
+
+  private:
+    friend class QueryModel;
+    QuerySymbol(int id) : m_id(id), m_line(-1), m_outerScope(0) {}
+
+    int          m_id;
+    QCString     m_name;
+    QCString     m_localName;
+    QCString     m_kind;
+    QCString     m_type;
+    QCString     m_fileName;
+    int          m_line;
+    QuerySymbol *m_outerScope;
+    QList<QuerySymbol> m_references;
+    QList<QuerySymbol> m_referencedBy;
+    QList<QuerySymbol> m_baseClasses;
+    QList<QuerySymbol> m_subClasses;
+};
+
+/** @brief Query layer over the symbols found by doxygen.
+ *
+ *  The model is built once after parseInput() and cross reference
+ *  gathering have finished. It keeps indexes by name and by the types
+ *  used in member declarations, and the reference and inheritance
+ *  relations in both directions, so queries do not need to walk
+ *  doxygen's global dictionaries. The model can be saved to a file
+ *  and loaded again without parsing the sources.
+ */
+class QueryModel
+{
+  public:
+    QueryModel();
+   ~QueryModel();
+
+    /** Builds the model from the symbols found by doxygen. */
+    void build();
+    /** Removes all symbols from the model. */
+    void clear();
+    /** Writes the model to \a fileName. Returns FALSE on failure. */
+    bool save(const char *fileName) const;
+    /** Replaces the model by the one stored in \a fileName.
+     *  Returns FALSE if the file could not be read.
+     */
+    bool load(const char *fileName);
+
+    /** Returns the number of symbols in the model. */
+    uint count() const { return m_symbols.count(); }
+    /** Returns all symbols in the model, in id order. */
+    const QList<QuerySymbol> &symbols() const { return m_symbols; }
+    /** Returns the symbol with id \a id, or 0 if there is none. */
+    QuerySymbol *symbol(int id) const;
+
+    /** Returns the symbols with the given qualified or local name,
+     *  or 0 if there are none.
+     */
+    const QList<QuerySymbol> *findSymbols(const char *name) const;
+    /** Returns the members whose type is or uses \a type,
+     *  or 0 if there are none.
+     */
+    const QList<QuerySymbol> *findMembersOfType(const char *type) const;
+    /** Adds the members that refer to any symbol named \a name to \a result. */
+    void findCallers(const char *name,QList<QuerySymbol> &result) const;
+    /** Adds all direct and indirect base classes of \a cls to \a result. */
+    void findAllBaseClasses(const QuerySymbol *cls,QList<QuerySymbol> &result) const;
+    /** Adds all direct and indirect sub classes of \a cls to \a result. */
+    void findAllSubClasses(const QuerySymbol *cls,QList<QuerySymbol> &result) const;
+
+  private:
+    QuerySymbol *addSymbol(Definition *d);
+    void addToIndex(QDict< QList<QuerySymbol> > &dict,const QCString &key,QuerySymbol *s);
+    void buildIndexes();
+    void closure(const QuerySymbol *s,bool up,QList<QuerySymbol> &result) const;
+
+    QList<QuerySymbol> m_symbols;
+    QArray<QuerySymbol*> m_byId; // indexed by QuerySymbol::id()
+    QDict< QList<QuerySymbol> > m_nameIndex;
+    QDict< QList<QuerySymbol> > m_typeIndex;
+};
+
+#endif
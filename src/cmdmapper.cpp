@@ -16,6 +16,8 @@
  *
  */
 
+#include <ctype.h>
+
 #include "cmdmapper.h"
 
 /** Call representing a mapping from a command name to a command ID. */
@@ -219,33 +221,171 @@ CommandMap htmlTagMap[] =
 Mapper *Mappers::cmdMapper     = new Mapper(cmdMap,TRUE);
 Mapper *Mappers::htmlTagMapper = new Mapper(htmlTagMap,FALSE);
 
-int Mapper::map(const char *n)
+//----------------------------------------------------------------------------
+
+static inline uint mixHash(uint h)
 {
-  QCString name=n;
-  if (!m_cs) name=name.lower();
-  int *result;
-  return !name.isEmpty() && (result=m_map.find(name)) ? *result: 0;
+  h ^= h >> 16;
+  h *= 0x85ebca6b;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35;
+  h ^= h >> 16;
+  return h;
 }
 
-QString Mapper::find(const int n)
+static inline uint nextPowerOfTwo(uint n)
+{
+  uint p=1;
+  while (p<n) p<<=1;
+  return p;
+}
+
+CommandHash::CommandHash(bool caseSensitive)
+  : m_cs(caseSensitive), m_seed(0), m_bucketMask(0), m_slotMask(0)
+{
+}
+
+uint CommandHash::hash(const char *name,uint seed) const
 {
-  QDictIterator<int> mapIterator(m_map);
-  for (int *curVal = mapIterator.toFirst();(curVal = mapIterator.current());++mapIterator)
+  // FNV-1a, folding to lower case for case insensitive tables
+  uint h = 2166136261u ^ seed;
+  const uchar *p = (const uchar *)name;
+  uchar c;
+  if (m_cs)
   {
-    if (*curVal == n || (*curVal == (n | SIMPLESECT_BIT))) return mapIterator.currentKey();
+    while ((c=*p++)) { h^=c; h*=16777619u; }
   }
-  return NULL;
+  else
+  {
+    while ((c=*p++)) { h^=(uchar)tolower(c); h*=16777619u; }
+  }
+  return h;
+}
+
+/** Tries to put the \a numKeys names in \a keys into free slots using
+ *  displacement \a disp. On failure the table is left unchanged.
+ */
+bool CommandHash::place(const QArray<uint> &hashes,const QArray<int> &keys,
+                        int numKeys,uint disp)
+{
+  int i;
+  for (i=0;i<numKeys;i++)
+  {
+    uint slot = mixHash(hashes[keys[i]]^disp) & m_slotMask;
+    if (m_slots[slot]!=-1) break;
+    m_slots[slot] = keys[i];
+  }
+  if (i==numKeys) return TRUE;
+  while (--i>=0) // undo
+  {
+    m_slots[mixHash(hashes[keys[i]]^disp) & m_slotMask] = -1;
+  }
+  return FALSE;
 }
 
-Mapper::Mapper(const CommandMap *cm,bool caseSensitive) : m_map(89), m_cs(caseSensitive)
+int CommandHash::build(const char * const *names,int count)
 {
-  m_map.setAutoDelete(TRUE);
-  const CommandMap *p = cm;
+  int i,j;
+  m_names.resize(count);
+  for (i=0;i<count;i++) m_names[i]=names[i];
+
+  // only the first occurrence of a name is entered in the table
+  int firstDuplicate=-1;
+  QArray<char> duplicate(count);
+  for (i=0;i<count;i++)
+  {
+    duplicate[i]=FALSE;
+    for (j=0;j<i && !duplicate[i];j++)
+    {
+      duplicate[i] = m_cs ? qstrcmp(names[i],names[j])==0 :
+                            qstricmp(names[i],names[j])==0;
+    }
+    if (duplicate[i] && firstDuplicate==-1) firstDuplicate=i;
+  }
+
+  uint numBuckets = nextPowerOfTwo(QMAX(count/2,1));
+  m_bucketMask = numBuckets-1;
+  m_slotMask   = nextPowerOfTwo(QMAX(count*2,1))-1;
+  m_disp.resize(numBuckets);
+  m_slots.resize(m_slotMask+1);
+
+  QArray<uint> hashes(count);
+  QArray<int>  bucketSize(numBuckets);
+  QArray<int>  keys(count);
+  for (m_seed=0;;m_seed++)
+  {
+    for (i=0;i<count;i++) hashes[i]=hash(names[i],m_seed);
+    m_disp.fill(0);
+    m_slots.fill(-1);
+    bucketSize.fill(0);
+    for (i=0;i<count;i++)
+    {
+      if (!duplicate[i]) bucketSize[hashes[i]&m_bucketMask]++;
+    }
+    int maxSize=0;
+    for (uint b=0;b<numBuckets;b++) maxSize=QMAX(maxSize,bucketSize[b]);
+
+    // place the largest buckets first, while most slots are still free
+    bool ok=TRUE;
+    for (int size=maxSize;ok && size>0;size--)
+    {
+      for (uint b=0;ok && b<numBuckets;b++)
+      {
+        if (bucketSize[b]!=size) continue;
+        int numKeys=0;
+        for (i=0;i<count;i++)
+        {
+          if (!duplicate[i] && (hashes[i]&m_bucketMask)==b) keys[numKeys++]=i;
+        }
+        uint disp;
+        for (disp=0;disp<0x10000 && !place(hashes,keys,numKeys,disp);disp++) {}
+        if (disp<0x10000)
+          m_disp[b]=disp;
+        else
+          ok=FALSE; // try again with another seed
+      }
+    }
+    if (ok) return firstDuplicate;
+  }
+}
+
+int CommandHash::find(const char *name) const
+{
+  if (name==0 || m_names.isEmpty()) return -1;
+  uint h = hash(name,m_seed);
+  int i = m_slots[mixHash(h^m_disp[h&m_bucketMask]) & m_slotMask];
+  if (i==-1) return -1;
+  bool match = m_cs ? qstrcmp(name,m_names[i])==0 : qstricmp(name,m_names[i])==0;
+  return match ? i : -1;
+}
+
+//----------------------------------------------------------------------------
+
+int Mapper::map(const char *n)
+{
+  if (n==0 || *n==0) return 0;
+  int i = m_hash.find(n);
+  return i!=-1 ? m_map[i].cmdId : 0;
+}
+
+QString Mapper::find(const int n)
+{
+  const CommandMap *p = m_map;
   while (p->cmdName)
   {
-    m_map.insert(p->cmdName,new int(p->cmdId));
+    if (p->cmdId == n || (p->cmdId == (n | SIMPLESECT_BIT))) return p->cmdName;
     p++;
   }
+  return NULL;
+}
+
+Mapper::Mapper(const CommandMap *cm,bool caseSensitive) : m_map(cm), m_hash(caseSensitive)
+{
+  int count=0;
+  while (cm[count].cmdName) count++;
+  QArray<const char *> names(count);
+  for (int i=0;i<count;i++) names[i]=cm[i].cmdName;
+  m_hash.build(names.data(),count);
 }
 
 void Mappers::freeMappers()
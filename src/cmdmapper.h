@@ -19,7 +19,8 @@
 #ifndef _CMDMAPPER_H
 #define _CMDMAPPER_H
 
-#include <qdict.h>
+#include <qarray.h>
+#include <qstring.h>
 
 struct CommandMap;
 
@@ -197,6 +198,42 @@ enum HtmlTagType
   XML_INHERITDOC   = XML_CmdMask + 22
 };
 
+/** @brief Perfect hash over a fixed set of command or tag names.
+ *
+ *  The names are distributed over buckets by their hash value. For each
+ *  bucket a displacement is searched that puts all of its names into
+ *  free slots of the table, so every name gets a slot of its own. A lookup
+ *  hashes the name once and does a single string compare, without
+ *  allocating memory.
+ */
+class CommandHash
+{
+  public:
+    CommandHash(bool caseSensitive);
+    /** Builds the table for the \a count names in \a names. The strings are
+     *  not copied and must stay valid. A name that occurs more than once is
+     *  only entered for its first occurrence. Returns the index of the first
+     *  repeated name, or -1 if all names are unique.
+     */
+    int build(const char * const *names,int count);
+    /** Returns the index of \a name in the array passed to build(),
+     *  or -1 if the name is unknown.
+     */
+    int find(const char *name) const;
+  private:
+    uint hash(const char *name,uint seed) const;
+    bool place(const QArray<uint> &hashes,const QArray<int> &keys,
+               int numKeys,uint disp);
+
+    bool m_cs;
+    uint m_seed;
+    uint m_bucketMask;
+    uint m_slotMask;
+    QArray<uint> m_disp;
+    QArray<int>  m_slots;
+    QArray<const char *> m_names;
+};
+
 /** Class representing a mapping from command names to command IDs. */
 class Mapper
 {
@@ -205,8 +242,8 @@ class Mapper
     QString find(const int n);
     Mapper(const CommandMap *cm,bool caseSensitive);
   private:
-    QDict<int> m_map;
-    bool m_cs;
+    const CommandMap *m_map;
+    CommandHash m_hash;
 };
 
 /** Class representing a namespace for the doxygen and HTML command mappers. */
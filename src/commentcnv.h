@@ -20,6 +20,12 @@
 
 class BufStr;
 
+/** Converts the C++ comments in \a inBuf to C comments and writes the
+ *  result to \a outBuf. The contents of \a inBuf are scanned in place and
+ *  are temporarily modified during the call; they are restored afterwards.
+ *  The converter keeps its state in static variables, so it is not 
+ *  reentrant.
+ */
 extern void convertCppComments(BufStr *inBuf,BufStr *outBuf,
                                const char *fileName);
 
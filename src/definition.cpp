@@ -41,6 +41,7 @@
 #include "namespacedef.h"
 #include "filedef.h"
 #include "dirdef.h"
+#include "symboltable.h"
 
 #define START_MARKER 0x4445465B // DEF[
 #define END_MARKER   0x4445465D // DEF]
@@ -112,7 +113,7 @@ DefinitionImpl::~DefinitionImpl()
 
 void DefinitionImpl::init(const char *df, const char *n)
 {
-  defFileName = df;
+  defFileName = internString(df);
   int lastDot = defFileName.findRev('.');
   if (lastDot!=-1)
   {
@@ -248,6 +249,8 @@ void Definition::addToMap(const char *name,Definition *d)
     }
 
     d->_setSymbolName(symbolName);
+    d->m_symbolId = Doxygen::symbolTable->intern(symbolName);
+    Doxygen::symbolTable->add(d->m_symbolId,d);
   }
 }
 
@@ -278,15 +281,21 @@ void Definition::removeFromMap(Definition *d)
       }
     }
   }
+  if (d->m_symbolId!=-1 && Doxygen::symbolTable)
+  {
+    Doxygen::symbolTable->remove(d->m_symbolId,d);
+    d->m_symbolId=-1;
+  }
 }
 
 Definition::Definition(const char *df,int dl,int dc,
                        const char *name,const char *b,
                        const char *d,bool isSymbol)
 {
-  m_name = name;
+  m_name = internString(name);
   m_defLine = dl;
   m_defColumn = dc;
+  m_symbolId = -1;
   m_impl = new DefinitionImpl;
   m_impl->init(df,name);
   m_isSymbol = isSymbol;
@@ -303,6 +312,7 @@ Definition::Definition(const Definition &d) : DefinitionIntf()
 {
   m_name = d.m_name;
   m_defLine = d.m_defLine;
+  m_symbolId = -1;
   m_impl = new DefinitionImpl;
   *m_impl = *d.m_impl;
   m_impl->sectionDict = 0;
@@ -384,6 +394,8 @@ Definition::~Definition()
   {
     removeFromMap(this);
   }
+  // cached accessibility results may refer to this definition
+  clearAccessibilityCache();
   if (m_impl)
   {
     delete m_impl;
@@ -394,7 +406,7 @@ Definition::~Definition()
 void Definition::setName(const char *name)
 {
   if (name==0) return;
-  m_name = name;
+  m_name = internString(name);
 }
 
 void Definition::setId(const char *id)
@@ -596,12 +608,12 @@ void Definition::_setDocumentation(const char *d,const char *docFile,int docLine
     }
     if (docLine!=-1) // store location if valid
     {
-      m_impl->details->file = docFile;
+      m_impl->details->file = internString(docFile);
       m_impl->details->line = docLine;
     }
     else
     {
-      m_impl->details->file = docFile;
+      m_impl->details->file = internString(docFile);
       m_impl->details->line = 1;
     }
   }
@@ -666,12 +678,12 @@ void Definition::_setBriefDescription(const char *b,const char *briefFile,int br
       m_impl->brief->doc=brief;
       if (briefLine!=-1)
       {
-        m_impl->brief->file = briefFile;
+        m_impl->brief->file = internString(briefFile);
         m_impl->brief->line = briefLine;
       }
       else
       {
-        m_impl->brief->file = briefFile;
+        m_impl->brief->file = internString(briefFile);
         m_impl->brief->line = 1;
       }
     }
@@ -697,7 +709,7 @@ void Definition::_setInbodyDocumentation(const char *doc,const char *inbodyFile,
   if (m_impl->inbodyDocs->doc.isEmpty()) // fresh inbody docs
   {
     m_impl->inbodyDocs->doc  = doc;
-    m_impl->inbodyDocs->file = inbodyFile;
+    m_impl->inbodyDocs->file = internString(inbodyFile);
     m_impl->inbodyDocs->line = inbodyLine;
   }
   else // another inbody documentation fragment, append this to the end
@@ -1400,9 +1412,10 @@ QCString Definition::qualifiedName() const
   }
   else
   {
-    m_impl->qualifiedName = m_impl->outerScope->qualifiedName()+
+    // the qualified name usually equals name(), so share its data
+    m_impl->qualifiedName = internString(m_impl->outerScope->qualifiedName()+
            getLanguageSpecificSeparator(getLanguage())+
-           m_impl->localName;
+           m_impl->localName);
   }
   //printf("end %s::qualifiedName()=%s\n",name().data(),m_impl->qualifiedName.data());
   //count--;
@@ -362,6 +362,7 @@ class Definition : public DefinitionIntf
     QCString m_name;
     bool m_isSymbol;
     QCString m_symbolName;
+    int m_symbolId;  // id of m_symbolName in Doxygen::symbolTable or -1
     int m_defLine;
     int m_defColumn;
 };
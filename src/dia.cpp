@@ -32,6 +32,24 @@ void writeDiaGraphFromFile(const char *inFile,const char *outDir,
   absOutFile+=portable_pathSeparator();
   absOutFile+=outFile;
 
+  // skip running dia if the input and the requested format are unchanged
+  // since the previous run and the image is still present
+  bool pdfNeeded = format==DIA_EPS && Config_getBool("USE_PDFLATEX");
+  {
+    QCString sigStr = computeFileMd5(inFile,
+                          QCString().setNum((int)format)+(pdfNeeded?"pdf":""));
+    QCString imgExt;
+    if (format==DIA_BITMAP) imgExt=".png";
+    else if (format==DIA_EPS) imgExt=".eps";
+    if (!sigStr.isEmpty() &&
+        !checkAndUpdateMd5Signature(absOutFile,sigStr) &&
+        checkDeliverables(absOutFile+imgExt,
+                          pdfNeeded ? absOutFile+".pdf" : QCString()))
+    {
+      return;
+    }
+  }
+
   // chdir to the output dir, so dot can find the font file.
   QCString oldDir = QDir::currentDirPath().utf8();
   // go to the html output directory (i.e. path)
@@ -69,7 +87,7 @@ void writeDiaGraphFromFile(const char *inFile,const char *outDir,
     goto error;
   }
   portable_sysTimerStop();
-  if ( (format==DIA_EPS) && (Config_getBool("USE_PDFLATEX")) )
+  if (pdfNeeded)
   {
     QCString epstopdfArgs(maxCmdLine);
     epstopdfArgs.sprintf("\"%s.eps\" --outfile=\"%s.pdf\"",
@@ -24,7 +24,7 @@ DirDef::DirDef(const char *path) : Definition(path,1,1,path), visited(FALSE)
   // get display name (stipping the paths mentioned in STRIP_FROM_PATH)
   // get short name (last part of path)
   m_shortName = path;
-  m_diskName = path;
+  setDiskName(path);
   if (m_shortName.at(m_shortName.length()-1)=='/')
   { // strip trailing /
     m_shortName = m_shortName.left(m_shortName.length()-1);
@@ -110,11 +110,13 @@ static QCString encodeDirName(const QCString &anchor)
 //  return result;
 }
 
-QCString DirDef::getOutputFileBase() const
+void DirDef::setDiskName(const QCString &name)
 {
-  //printf("DirDef::getOutputFileBase() %s->dir_%s\n",
-  //    m_diskName.data(),encodeDirName(m_diskName).data());
-  return "dir_"+encodeDirName(m_diskName);
+  m_diskName = name;
+  // the output file name is a hash of the disk name, so compute it once
+  m_outputFileBase = "dir_"+encodeDirName(m_diskName);
+  //printf("DirDef::setDiskName() %s->%s\n",
+  //    m_diskName.data(),m_outputFileBase.data());
 }
 
 void DirDef::writeDetailedDescription(OutputList &ol,const QCString &title)
@@ -505,10 +507,13 @@ void DirDef::setLevel()
 }
 
 /** Add as "uses" dependency between \a this dir and \a dir,
- *  that was caused by a dependency on file \a fd.
+ *  that was caused by a dependency on file \a fd. The key of the
+ *  file pair \a pairKey is passed along, so it is computed only once
+ *  per include.
  */ 
 void DirDef::addUsesDependency(DirDef *dir,FileDef *srcFd,
-                               FileDef *dstFd,bool inherited)
+                               FileDef *dstFd,const QCString &pairKey,
+                               bool inherited)
 {
   if (this==dir) return; // do not add self-dependencies
   //static int count=0;
@@ -523,12 +528,11 @@ void DirDef::addUsesDependency(DirDef *dir,FileDef *srcFd,
   UsedDir *usedDir = m_usedDirs->find(dir->getOutputFileBase());
   if (usedDir) // dir dependency already present
   {
-     FilePair *usedPair = usedDir->findFilePair(
-         srcFd->getOutputFileBase()+dstFd->getOutputFileBase());
+     FilePair *usedPair = usedDir->findFilePair(pairKey);
      if (usedPair==0) // new file dependency
      {
        //printf("  => new file\n");
-       usedDir->addFileDep(srcFd,dstFd); 
+       usedDir->addFileDep(srcFd,dstFd,pairKey); 
        added=TRUE;
      }
      else
@@ -540,7 +544,7 @@ void DirDef::addUsesDependency(DirDef *dir,FileDef *srcFd,
   {
     //printf("  => new file\n");
     usedDir = new UsedDir(dir,inherited);
-    usedDir->addFileDep(srcFd,dstFd); 
+    usedDir->addFileDep(srcFd,dstFd,pairKey); 
     m_usedDirs->insert(dir->getOutputFileBase(),usedDir);
     added=TRUE;
   }
@@ -549,12 +553,12 @@ void DirDef::addUsesDependency(DirDef *dir,FileDef *srcFd,
     if (dir->parent())
     {
       // add relation to parent of used dir
-      addUsesDependency(dir->parent(),srcFd,dstFd,inherited);
+      addUsesDependency(dir->parent(),srcFd,dstFd,pairKey,inherited);
     }
     if (parent())
     {
       // add relation for the parent of this dir as well
-      parent()->addUsesDependency(dir,srcFd,dstFd,TRUE);
+      parent()->addUsesDependency(dir,srcFd,dstFd,pairKey,TRUE);
     }
   }
 }
@@ -570,6 +574,7 @@ void DirDef::computeDependencies()
     FileDef *fd;
     for (fli.toFirst();(fd=fli.current());++fli) // foreach file in dir dd
     {
+      QCString srcBase = fd->getOutputFileBase();
       //printf("  File %s\n",fd->name().data());
       //printf("** dir=%s file=%s\n",shortName().data(),fd->name().data());
       QList<IncludeInfo> *ifl = fd->includeFileList();
@@ -589,7 +594,8 @@ void DirDef::computeDependencies()
               // add dependency: thisDir->usedDir
               //static int count=0;
               //printf("      %d: add dependency %s->%s\n",count++,name().data(),usedDir->name().data());
-              addUsesDependency(usedDir,fd,ii->fileDef,FALSE);
+              addUsesDependency(usedDir,fd,ii->fileDef,
+                                srcBase+ii->fileDef->getOutputFileBase(),FALSE);
             }
           } 
         }
@@ -635,10 +641,15 @@ UsedDir::~UsedDir()
 }
 
 
-void UsedDir::addFileDep(FileDef *srcFd,FileDef *dstFd)
+void UsedDir::addFileDep(FileDef *srcFd,FileDef *dstFd,const QCString &pairKey)
 {
-  m_filePairs.inSort(srcFd->getOutputFileBase()+dstFd->getOutputFileBase(),
-                     new FilePair(srcFd,dstFd));
+  // the pairs are sorted once all dependencies are known, see sort()
+  m_filePairs.append(pairKey,new FilePair(srcFd,dstFd));
+}
+
+void UsedDir::sort()
+{
+  m_filePairs.sort();
 }
 
 FilePair *UsedDir::findFilePair(const char *name)
@@ -938,6 +949,16 @@ void computeDirDependencies()
     //printf("computeDependencies for %s: #dirs=%d\n",dir->name().data(),Doxygen::directories.count());
     dir->computeDependencies();
   }
+  // sort the file dependencies once, instead of at each insertion
+  for (sdi.toFirst();(dir=sdi.current());++sdi)
+  {
+    QDictIterator<UsedDir> udi(*dir->m_usedDirs);
+    UsedDir *udir;
+    for (udi.toFirst();(udir=udi.current());++udi)
+    {
+      udir->sort();
+    }
+  }
 
 }
 
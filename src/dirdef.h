@@ -49,7 +49,7 @@ class DirDef : public Definition
 
     // accessors
     DefType definitionType() const { return TypeDir; }
-    QCString getOutputFileBase() const;
+    QCString getOutputFileBase() const { return m_outputFileBase; }
     QCString anchor() const { return QCString(); }
     bool isLinkableInProject() const;
     bool isLinkable() const;
@@ -76,7 +76,7 @@ class DirDef : public Definition
 
     static DirDef *mergeDirectoryInTree(const QCString &path);
     bool visited;
-    void setDiskName(const QCString &name) { m_diskName = name; }
+    void setDiskName(const QCString &name);
 
   private:
     friend void computeDirDependencies();
@@ -93,13 +93,14 @@ class DirDef : public Definition
     static DirDef *createNewDir(const char *path);
     static bool matchPath(const QCString &path,QStrList &l);
     void addUsesDependency(DirDef *usedDir,FileDef *srcFd,
-                           FileDef *dstFd,bool inherited);
+                           FileDef *dstFd,const QCString &pairKey,bool inherited);
     void computeDependencies();
 
     DirList m_subdirs;
     QCString m_dispName;
     QCString m_shortName;
     QCString m_diskName;
+    QCString m_outputFileBase;
     FileList *m_fileList;                 // list of files in the group
     int m_dirCount;
     int m_level;
@@ -134,8 +135,9 @@ class UsedDir
   public:
     UsedDir(DirDef *dir,bool inherited);
     virtual ~UsedDir();
-    void addFileDep(FileDef *srcFd,FileDef *dstFd);
+    void addFileDep(FileDef *srcFd,FileDef *dstFd,const QCString &pairKey);
     FilePair *findFilePair(const char *name);
+    void sort();
     const FilePairDict &filePairs() const { return m_filePairs; }
     const DirDef *dir() const { return m_dir; }
     bool inherited() const { return m_inherited; }
@@ -352,7 +352,7 @@ void DocbookDocVisitor::visit(DocInclude *inc)
       Doxygen::parserManager->getParser(inc->extension())
         ->parseCode(m_ci,
             inc->context(),
-            extractBlock(inc->text(),inc->blockId()),
+            inc->text(),
             langExt,
             inc->isExample(),
             inc->exampleFile()
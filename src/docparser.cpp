@@ -25,6 +25,7 @@
 #include <qstack.h>
 #include <qdict.h>
 #include <qregexp.h>
+#include <qcache.h>
 #include <ctype.h>
 
 #include "doxygen.h"
@@ -1741,7 +1742,7 @@ static int internalValidatingParseDoc(DocNode *parent,QList<DocNode> &children,
 
 //---------------------------------------------------------------------------
 
-static void readTextFileByName(const QCString &file,QCString &text)
+static bool readTextFileByName(const QCString &file,QCString &text)
 {
   if (portable_isAbsolutePath(file.data()))
   {
@@ -1749,7 +1750,7 @@ static void readTextFileByName(const QCString &file,QCString &text)
     if (fi.exists())
     {
       text = fileToString(file,Config_getBool("FILTER_SOURCE_FILES"));
-      return;
+      return TRUE;
     }
   }
   QStrList &examplePathList = Config_getList("EXAMPLE_PATH");
@@ -1761,7 +1762,7 @@ static void readTextFileByName(const QCString &file,QCString &text)
     if (fi.exists())
     {
       text = fileToString(absFileName,Config_getBool("FILTER_SOURCE_FILES"));
-      return;
+      return TRUE;
     }
     s=examplePathList.next(); 
   }
@@ -1772,6 +1773,7 @@ static void readTextFileByName(const QCString &file,QCString &text)
   if ((fd=findFileDef(Doxygen::exampleNameDict,file,ambig)))
   {
     text = fileToString(fd->absFilePath(),Config_getBool("FILTER_SOURCE_FILES"));
+    return TRUE;
   }
   else if (ambig)
   {
@@ -1785,6 +1787,190 @@ static void readTextFileByName(const QCString &file,QCString &text)
     warn_doc_error(g_fileName,doctokenizerYYlineno,"included file %s is not found. "
            "Check your EXAMPLE_PATH",qPrint(file));
   }
+  return FALSE;
+}
+
+/** Block of text marked for use with the \\snippet command */
+struct SnippetInfo
+{
+  SnippetInfo(const QCString &b,int c) : block(b), markerCount(c) {}
+  QCString block;   //!< the text between the markers
+  int markerCount;  //!< number of times the marker appears in the file
+};
+
+// the cost of the items in the caches below is their number of characters
+static const int includeCacheCost = 64*1024*1024;
+static QCache<QCString>    g_includeFileCache(includeCacheCost,1009);
+static QCache<SnippetInfo> g_snippetCache(includeCacheCost,1009);
+
+/*! Reads the contents of \a file for one of the include commands into 
+ *  \a text. Since the same example file is often included many times, 
+ *  the contents are kept in a cache, so the EXAMPLE_PATH does not need to
+ *  be searched and the file does not need to be read (and possibly 
+ *  filtered) again.
+ */
+static bool readIncludeFile(const QCString &file,QCString &text)
+{
+  static bool init=FALSE;
+  if (!init)
+  {
+    g_includeFileCache.setAutoDelete(TRUE);
+    g_snippetCache.setAutoDelete(TRUE);
+    init=TRUE;
+  }
+  QCString *cachedText = g_includeFileCache.find(file);
+  if (cachedText)
+  {
+    text = *cachedText;
+    return TRUE;
+  }
+  if (!readTextFileByName(file,text)) return FALSE;
+  cachedText = new QCString(text);
+  if (!g_includeFileCache.insert(file,cachedText,QMAX(1,(int)text.length())))
+  {
+    delete cachedText; // too large to be cached
+  }
+  return TRUE;
+}
+
+/*! Returns the block of \a file marked with \a blockId for use with the
+ *  \\snippet command. The number of times the marker was found is 
+ *  returned in \a markerCount, or -1 if the file could not be read. 
+ *  The result is cached per file and marker, so repeated uses of the same
+ *  snippet do not need to scan the whole file again.
+ */
+static QCString readSnippet(const QCString &file,const QCString &blockId,int &markerCount)
+{
+  QCString key = file+"\n"+blockId;
+  SnippetInfo *si = g_snippetCache.find(key);
+  if (si==0)
+  {
+    QCString text;
+    if (!readIncludeFile(file,text)) 
+    {
+      markerCount=-1;
+      return QCString();
+    }
+    int count = blockId.isEmpty() ? 0 : text.contains(blockId.data());
+    si = new SnippetInfo(extractBlock(text,blockId),count);
+    if (!g_snippetCache.insert(key,si,QMAX(1,(int)si->block.length())))
+    {
+      markerCount = si->markerCount;
+      QCString result = si->block;
+      delete si; // too large to be cached
+      return result;
+    }
+  }
+  markerCount = si->markerCount;
+  return si->block;
+}
+
+
+//---------------------------------------------------------------------------
+
+/** Allocator for the nodes of the documentation tree.
+ *
+ *  Each documentation block is parsed into a tree that is thrown away
+ *  as soon as it has been written, so nodes are created and destroyed at
+ *  a very high rate. Instead of going through malloc and free for every
+ *  node, memory is taken from large blocks and freed nodes are kept in a
+ *  free list per size class, so they can be reused. When the last node
+ *  is deleted, normally at the end of a parse, all blocks are released.
+ */
+class DocNodeAllocator
+{
+  public:
+    static void *alloc(size_t size)
+    {
+      if (size>MaxSize) return malloc(size);
+      s_live++;
+      int sc = sizeClass(size);
+      FreeItem *item = s_freeLists[sc];
+      if (item) // reuse a freed node
+      {
+        s_freeLists[sc] = item->next;
+        return item;
+      }
+      size_t allocSize = (sc+1)*Granularity;
+      if (allocSize>s_blockLeft) // current block is exhausted
+      {
+        Block *block = (Block *)malloc(sizeof(Block));
+        block->next = s_blocks;
+        s_blocks = block;
+        s_blockPtr = block->data;
+        s_blockLeft = BlockSize;
+      }
+      void *result = s_blockPtr;
+      s_blockPtr += allocSize;
+      s_blockLeft -= allocSize;
+      return result;
+    }
+    static void release(void *p,size_t size)
+    {
+      if (p==0) return;
+      if (size>MaxSize) { free(p); return; }
+      int sc = sizeClass(size);
+      FreeItem *item = (FreeItem *)p;
+      item->next = s_freeLists[sc];
+      s_freeLists[sc] = item;
+      if (--s_live==0) freeBlocks();
+    }
+
+  private:
+    enum { Granularity = 16, 
+           MaxSize     = 512, 
+           NumClasses  = MaxSize/Granularity,
+           BlockSize   = 64*1024 
+         };
+    struct FreeItem 
+    { 
+      FreeItem *next; 
+    };
+    struct Block
+    {
+      Block *next;
+      double align; // makes sure data is suitably aligned
+      char data[BlockSize];
+    };
+    static int sizeClass(size_t size)
+    {
+      return size==0 ? 0 : (int)((size-1)/Granularity);
+    }
+    /** Releases all blocks; only called when no node is in use. */
+    static void freeBlocks()
+    {
+      while (s_blocks)
+      {
+        Block *next = s_blocks->next;
+        free(s_blocks);
+        s_blocks = next;
+      }
+      int i;
+      for (i=0;i<NumClasses;i++) s_freeLists[i]=0;
+      s_blockPtr  = 0;
+      s_blockLeft = 0;
+    }
+    static FreeItem *s_freeLists[NumClasses];
+    static Block    *s_blocks;
+    static char     *s_blockPtr;
+    static size_t    s_blockLeft;
+    static int       s_live; // number of nodes in use taken from the blocks
+};
+
+DocNodeAllocator::FreeItem *DocNodeAllocator::s_freeLists[DocNodeAllocator::NumClasses];
+DocNodeAllocator::Block    *DocNodeAllocator::s_blocks    = 0;
+char                       *DocNodeAllocator::s_blockPtr  = 0;
+size_t                      DocNodeAllocator::s_blockLeft = 0;
+int                         DocNodeAllocator::s_live      = 0;
+
+void *DocNode::operator new(size_t size)
+{
+  return DocNodeAllocator::alloc(size);
+}
+
+void DocNode::operator delete(void *p,size_t size)
+{
+  DocNodeAllocator::release(p,size);
 }
 
 //---------------------------------------------------------------------------
@@ -1894,7 +2080,7 @@ void DocInclude::parse()
     case Include:
       // fall through
     case DontInclude:
-      readTextFileByName(m_file,m_text);
+      readIncludeFile(m_file,m_text);
       g_includeFileText   = m_text;
       g_includeFileOffset = 0;
       g_includeFileLength = m_text.length();
@@ -1903,20 +2089,23 @@ void DocInclude::parse()
     case VerbInclude: 
       // fall through
     case HtmlInclude:
-      readTextFileByName(m_file,m_text);
+      readIncludeFile(m_file,m_text);
       break;
     case LatexInclude:
-      readTextFileByName(m_file,m_text);
+      readIncludeFile(m_file,m_text);
       break;
     case Snippet:
-      readTextFileByName(m_file,m_text);
-      // check here for the existence of the blockId inside the file, so we
-      // only generate the warning once.
-      int count;
-      if (!m_blockId.isEmpty() && (count=m_text.contains(m_blockId.data()))!=2)
-      {
-        warn_doc_error(g_fileName,doctokenizerYYlineno,"block marked with %s for \\snippet should appear twice in file %s, found it %d times\n",
-            m_blockId.data(),m_file.data(),count);
+      {
+        // only the marked block of the file is kept as the text
+        int count;
+        m_text = readSnippet(m_file,m_blockId,count);
+        // check here for the existence of the blockId inside the file, so we
+        // only generate the warning once.
+        if (!m_blockId.isEmpty() && count!=-1 && count!=2)
+        {
+          warn_doc_error(g_fileName,doctokenizerYYlineno,"block marked with %s for \\snippet should appear twice in file %s, found it %d times\n",
+              m_blockId.data(),m_file.data(),count);
+        }
       }
       break;
   }
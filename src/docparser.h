@@ -140,6 +140,12 @@ class DocNode
     /*! Destroys a node. */
     virtual ~DocNode() {}
 
+    /*! Nodes are allocated from a pool, since many are created and 
+     *  destroyed for each documentation block. 
+     */
+    static void *operator new(size_t size);
+    static void operator delete(void *p,size_t size);
+
     /*! Returns the kind of node. Provides runtime type information */
     virtual Kind kind() const = 0;
 
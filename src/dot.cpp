@@ -724,56 +724,6 @@ static void removeDotGraph(const QCString &dotName)
 
 
 
-/*! Checks if a file "baseName".md5 exists. If so the contents
- *  are compared with \a md5. If equal FALSE is returned. If the .md5
- *  file does not exist or its contents are not equal to \a md5, 
- *  a new .md5 is generated with the \a md5 string as contents.
- */
-static bool checkAndUpdateMd5Signature(const QCString &baseName,
-            const QCString &md5)
-{
-  QFile f(baseName+".md5");
-  if (f.open(IO_ReadOnly))
-  {
-    // read checksum
-    QCString md5stored(33);
-    int bytesRead=f.readBlock(md5stored.rawData(),32);
-    md5stored[32]='\0';
-    // compare checksum
-    if (bytesRead==32 && md5==md5stored)
-    {
-      // bail out if equal
-      return FALSE;
-    }
-  }
-  f.close();
-  // create checksum file
-  if (f.open(IO_WriteOnly))
-  {
-    f.writeBlock(md5.data(),32); 
-    f.close();
-  }
-  return TRUE;
-}
-
-static bool checkDeliverables(const QCString &file1,
-                              const QCString &file2=QCString())
-{
-  bool file1Ok = TRUE;
-  bool file2Ok = TRUE;
-  if (!file1.isEmpty())
-  {
-    QFileInfo fi(file1);
-    file1Ok = (fi.exists() && fi.size()>0);
-  }
-  if (!file2.isEmpty())
-  {
-    QFileInfo fi(file2);
-    file2Ok = (fi.exists() && fi.size()>0);
-  }
-  return file1Ok && file2Ok;
-}
-
 //--------------------------------------------------------------------
 
 inline int DotNode::findParent( DotNode *n )
@@ -3469,7 +3419,9 @@ DotInclDepGraph::DotInclDepGraph(FileDef *fd,bool inverse)
                             TRUE     // root node
                            );
   m_startNode->setDistance(0);
-  m_usedNodes = new QDict<DotNode>(1009);
+  // size the node dictionary for the files in the include closure of fd
+  int numFiles = fd->numIncludeFilesRecursively(inverse);
+  m_usedNodes = new QDict<DotNode>(numFiles>500 ? numFiles*2+1 : 1009);
   m_usedNodes->insert(fd->absFilePath(),m_startNode);
   buildGraph(m_startNode,fd,1);
 
@@ -42,6 +42,7 @@
 #include "pre.h"
 #include "tagreader.h"
 #include "dot.h"
+#include "plantuml.h"
 #include "msc.h"
 #include "docparser.h"
 #include "dirdef.h"
@@ -99,6 +100,7 @@
 #include "settings.h"
 #include "context.h"
 #include "fileparser.h"
+#include "symboltable.h"
 
 // provided by the generated file resources.cpp
 extern void initResources();
@@ -109,6 +111,13 @@ extern void initResources();
     for (;eli.current();++eli) func(eli.current()); \
   } } while(0) 
 
+#define FOR_EACH_ENTRYNAV(func,match) \
+  do { EntryNavList enl; \
+    g_entryNavIndex.findSections(enl,match); \
+    EntryNavListIterator eli(enl); \
+    for (;eli.current();++eli) func(eli.current()); \
+  } while(0)
+
 
 #if !defined(_WIN32) || defined(__CYGWIN__)
 #include <signal.h>
@@ -151,6 +160,7 @@ bool             Doxygen::parseSourcesNeeded = FALSE;
 QTime            Doxygen::runningTime;
 SearchIndexIntf *Doxygen::searchIndex=0;
 QDict<DefinitionIntf> *Doxygen::symbolMap = 0;
+SymbolTable     *Doxygen::symbolTable = 0;
 QDict<Definition> *Doxygen::clangUsrMap = 0;
 bool             Doxygen::outputToWizard=FALSE;
 QDict<int> *     Doxygen::htmlDirMap = 0;
@@ -174,6 +184,8 @@ GenericsSDict   *Doxygen::genericsDict;
 
 // locally accessible globals
 static QDict<EntryNav>  g_classEntries(1009);
+static EntryNavIndex    g_entryNavIndex;      // entries of the tree by section, 
+                                              // filled by EntryNav::addChild()
 static StringList       g_inputFiles;         
 static QDict<void>      g_compoundKeywordDict(7);  // keywords recognised as compounds
 static OutputList      *g_outputList = 0;          // list of output generating objects
@@ -610,14 +622,22 @@ static void addRelatedPage(EntryNav *rootNav)
   }
 }
 
-static void buildGroupListFiltered(EntryNav *rootNav,bool additional, bool includeExternal)
+static bool isGroupSection(int section)
 {
-  if (rootNav->section()==Entry::GROUPDOC_SEC && !rootNav->name().isEmpty() && 
-        ((!includeExternal && rootNav->tagInfo()==0) ||
-         ( includeExternal && rootNav->tagInfo()!=0))
-     )
+  return section==Entry::GROUPDOC_SEC;
+}
+
+static void buildGroupListFiltered(const EntryNavList &groupNavs,bool additional, bool includeExternal)
+{
+  EntryNavListIterator eli(groupNavs);
+  EntryNav *rootNav;
+  for (;(rootNav=eli.current());++eli)
   {
-    rootNav->loadEntry(g_storage);
+    if ((!includeExternal && rootNav->tagInfo()!=0) ||
+        ( includeExternal && rootNav->tagInfo()==0))
+    {
+      continue;
+    }
     Entry *root = rootNav->entry();
 
     if ((root->groupDocType==Entry::GROUPDOC_NORMAL && !additional) ||
@@ -667,33 +687,22 @@ static void buildGroupListFiltered(EntryNav *rootNav,bool additional, bool inclu
         gd->setLanguage(root->lang);
       }
     }
-
-    rootNav->releaseEntry();
-  }
-  if (rootNav->children())
-  {
-    EntryNavListIterator eli(*rootNav->children());
-    EntryNav *e;
-    for (;(e=eli.current());++eli)
-    {
-      buildGroupListFiltered(e,additional,includeExternal);
-    }
   }
 }
 
-static void buildGroupList(EntryNav *rootNav)
+static void buildGroupList(const EntryNavList &groupNavs)
 {
   // --- first process only local groups
   // first process the @defgroups blocks
-  buildGroupListFiltered(rootNav,FALSE,FALSE);
+  buildGroupListFiltered(groupNavs,FALSE,FALSE);
   // then process the @addtogroup, @weakgroup blocks
-  buildGroupListFiltered(rootNav,TRUE,FALSE);
+  buildGroupListFiltered(groupNavs,TRUE,FALSE);
 
   // --- then also process external groups
   // first process the @defgroups blocks
-  buildGroupListFiltered(rootNav,FALSE,TRUE);
+  buildGroupListFiltered(groupNavs,FALSE,TRUE);
   // then process the @addtogroup, @weakgroup blocks
-  buildGroupListFiltered(rootNav,TRUE,TRUE);
+  buildGroupListFiltered(groupNavs,TRUE,TRUE);
 }
 
 static void findGroupScope(EntryNav *rootNav)
@@ -718,14 +727,14 @@ static void findGroupScope(EntryNav *rootNav)
       }
     }
   }
-  RECURSE_ENTRYTREE(findGroupScope,rootNav);
 }
 
-static void organizeSubGroupsFiltered(EntryNav *rootNav,bool additional)
+static void organizeSubGroupsFiltered(const EntryNavList &groupNavs,bool additional)
 {
-  if (rootNav->section()==Entry::GROUPDOC_SEC && !rootNav->name().isEmpty())
+  EntryNavListIterator eli(groupNavs);
+  EntryNav *rootNav;
+  for (;(rootNav=eli.current());++eli)
   {
-    rootNav->loadEntry(g_storage);
     Entry *root = rootNav->entry();
 
     if ((root->groupDocType==Entry::GROUPDOC_NORMAL && !additional) ||
@@ -738,32 +747,54 @@ static void organizeSubGroupsFiltered(EntryNav *rootNav,bool additional)
         addGroupToGroups(root,gd);
       }
     }
-
-    rootNav->releaseEntry();
-  }
-  if (rootNav->children())
-  {
-    EntryNavListIterator eli(*rootNav->children());
-    EntryNav *e;
-    for (;(e=eli.current());++eli)
-    {
-      organizeSubGroupsFiltered(e,additional);
-    }
   }
 }
 
-static void organizeSubGroups(EntryNav *rootNav)
+static void organizeSubGroups(const EntryNavList &groupNavs)
 {
   //printf("Defining groups\n");
   // first process the @defgroups blocks
-  organizeSubGroupsFiltered(rootNav,FALSE);
+  organizeSubGroupsFiltered(groupNavs,FALSE);
   //printf("Additional groups\n");
   // then process the @addtogroup, @weakgroup blocks
-  organizeSubGroupsFiltered(rootNav,TRUE);
+  organizeSubGroupsFiltered(groupNavs,TRUE);
+}
+
+/*! Builds the groups and their nesting from the group documentation
+ *  entries. The entries are loaded only once for all passes over them.
+ */
+static void buildGroups()
+{
+  EntryNavList allGroupNavs;
+  g_entryNavIndex.findSections(allGroupNavs,isGroupSection);
+  EntryNavList groupNavs;
+  EntryNavListIterator agli(allGroupNavs);
+  EntryNav *rootNav;
+  for (;(rootNav=agli.current());++agli)
+  {
+    // skip unnamed groups, none of the passes handle them
+    if (rootNav->section()==Entry::GROUPDOC_SEC && !rootNav->name().isEmpty())
+    {
+      rootNav->loadEntry(g_storage);
+      groupNavs.append(rootNav);
+    }
+  }
+  buildGroupList(groupNavs);
+  organizeSubGroups(groupNavs);
+  EntryNavListIterator eli(groupNavs);
+  for (;(rootNav=eli.current());++eli)
+  {
+    rootNav->releaseEntry();
+  }
 }
 
 //----------------------------------------------------------------------
 
+static bool isFileSection(int section)
+{
+  return section==Entry::FILEDOC_SEC || (section & Entry::FILE_MASK);
+}
+
 static void buildFileList(EntryNav *rootNav)
 {
   if (((rootNav->section()==Entry::FILEDOC_SEC) ||
@@ -838,7 +869,6 @@ static void buildFileList(EntryNav *rootNav)
 
     rootNav->releaseEntry();
   }
-  RECURSE_ENTRYTREE(buildFileList,rootNav);
 }
 
 static void addIncludeFile(ClassDef *cd,FileDef *ifd,Entry *root)
@@ -1403,6 +1433,11 @@ static void addClassToContext(EntryNav *rootNav)
 //----------------------------------------------------------------------
 // build a list of all classes mentioned in the documentation
 // and all classes that have a documentation block before their definition.
+static bool isClassDefSection(int section)
+{
+  return (section & Entry::COMPOUND_MASK) || section==Entry::OBJCIMPL_SEC;
+}
+
 static void buildClassList(EntryNav *rootNav)
 {
   if (
@@ -1412,7 +1447,11 @@ static void buildClassList(EntryNav *rootNav)
   {
     addClassToContext(rootNav);
   }
-  RECURSE_ENTRYTREE(buildClassList,rootNav);
+}
+
+static bool isClassDocSection(int section)
+{
+  return section & Entry::COMPOUNDDOC_MASK;
 }
 
 static void buildClassDocList(EntryNav *rootNav)
@@ -1423,7 +1462,6 @@ static void buildClassDocList(EntryNav *rootNav)
   {
     addClassToContext(rootNav);
   }
-  RECURSE_ENTRYTREE(buildClassDocList,rootNav);
 }
 
 static void resolveClassNestingRelations()
@@ -4952,13 +4990,17 @@ static bool isClassSection(EntryNav *rootNav)
 
 /*! Builds a dictionary of all entry nodes in the tree starting with \a root
  */
+static bool isClassOrClassDocSection(int section)
+{
+  return (section & Entry::COMPOUND_MASK) || (section & Entry::COMPOUNDDOC_MASK);
+}
+
 static void findClassEntries(EntryNav *rootNav)
 {
   if (isClassSection(rootNav))
   {
     g_classEntries.insert(rootNav->name(),rootNav);
   }
-  RECURSE_ENTRYTREE(findClassEntries,rootNav);
 }
 
 static QCString extractClassName(EntryNav *rootNav)
@@ -7424,6 +7466,11 @@ static void addEnumValuesToEnums(EntryNav *rootNav)
 //----------------------------------------------------------------------
 // find the documentation blocks for the enumerations
 
+static bool isEnumDocSection(int section)
+{
+  return section==Entry::ENUMDOC_SEC;
+}
+
 static void findEnumDocumentation(EntryNav *rootNav)
 {
   if (rootNav->section()==Entry::ENUMDOC_SEC
@@ -7562,7 +7609,6 @@ static void findEnumDocumentation(EntryNav *rootNav)
 
     rootNav->releaseEntry();
   }
-  RECURSE_ENTRYTREE(findEnumDocumentation,rootNav);
 }
 
 // search for each enum (member or function) in mnl if it has documented 
@@ -8428,6 +8474,11 @@ static void flushUnresolvedRelations()
 
 //----------------------------------------------------------------------------
 
+static bool isDefineSection(int section)
+{
+  return section==Entry::DEFINEDOC_SEC || section==Entry::DEFINE_SEC;
+}
+
 static void findDefineDocumentation(EntryNav *rootNav)
 {
   if ((rootNav->section()==Entry::DEFINEDOC_SEC ||
@@ -8567,11 +8618,15 @@ static void findDefineDocumentation(EntryNav *rootNav)
 
     rootNav->releaseEntry();
   }
-  RECURSE_ENTRYTREE(findDefineDocumentation,rootNav);
 }
 
 //----------------------------------------------------------------------------
 
+static bool isDirDocSection(int section)
+{
+  return section==Entry::DIRDOC_SEC;
+}
+
 static void findDirDocumentation(EntryNav *rootNav)
 {
   if (rootNav->section() == Entry::DIRDOC_SEC)
@@ -8632,30 +8687,67 @@ static void findDirDocumentation(EntryNav *rootNav)
     }
     rootNav->releaseEntry();
   }
-  RECURSE_ENTRYTREE(findDirDocumentation,rootNav);
 }
 
 
 //----------------------------------------------------------------------------
 // create a (sorted) list of separate documentation pages
 
+static bool isPageOrMainPageDocSection(int section)
+{
+  return section==Entry::PAGEDOC_SEC || section==Entry::MAINPAGEDOC_SEC;
+}
+
+/*! Loads the entries of all nodes whose section is matched by \a match
+ *  and appends the nodes to \a navs in tree order, so that several
+ *  passes can share the loaded entries.
+ */
+static void loadEntries(EntryNavList &navs,bool (*match)(int section))
+{
+  g_entryNavIndex.findSections(navs,match);
+  EntryNavListIterator eli(navs);
+  EntryNav *rootNav;
+  for (;(rootNav=eli.current());++eli)
+  {
+    rootNav->loadEntry(g_storage);
+  }
+}
+
+static void releaseEntries(const EntryNavList &navs)
+{
+  EntryNavListIterator eli(navs);
+  EntryNav *rootNav;
+  for (;(rootNav=eli.current());++eli)
+  {
+    rootNav->releaseEntry();
+  }
+}
+
+static void forEachEntryNav(const EntryNavList &navs,void (*func)(EntryNav *))
+{
+  EntryNavListIterator eli(navs);
+  EntryNav *rootNav;
+  for (;(rootNav=eli.current());++eli)
+  {
+    func(rootNav);
+  }
+}
+
+// the page passes below expect the entry of rootNav to be loaded
+
 static void buildPageList(EntryNav *rootNav)
 {
   if (rootNav->section() == Entry::PAGEDOC_SEC)
   {
-    rootNav->loadEntry(g_storage);
     Entry *root = rootNav->entry();
 
     if (!root->name.isEmpty())
     {
       addRelatedPage(rootNav);
     }
-
-    rootNav->releaseEntry();
   }
   else if (rootNav->section() == Entry::MAINPAGEDOC_SEC)
   {
-    rootNav->loadEntry(g_storage);
     Entry *root = rootNav->entry();
 
     QCString title=root->args.stripWhiteSpace();
@@ -8669,10 +8761,7 @@ static void buildPageList(EntryNav *rootNav)
                title,
                0,0
                );
-
-    rootNav->releaseEntry();
   }
-  RECURSE_ENTRYTREE(buildPageList,rootNav);
 }
 
 // search for the main page defined in this project
@@ -8680,8 +8769,6 @@ static void findMainPage(EntryNav *rootNav)
 {
   if (rootNav->section() == Entry::MAINPAGEDOC_SEC)
   {
-    rootNav->loadEntry(g_storage);
-
     if (Doxygen::mainPage==0 && rootNav->tagInfo()==0)
     {
       Entry *root = rootNav->entry();
@@ -8729,10 +8816,7 @@ static void findMainPage(EntryNav *rootNav)
            "found more than one \\mainpage comment block! (first occurrence: %s, line %d), Skipping current block!",
            Doxygen::mainPage->docFile().data(),Doxygen::mainPage->docLine());
     }
-
-    rootNav->releaseEntry();
   }
-  RECURSE_ENTRYTREE(findMainPage,rootNav);
 }
 
 // search for the main page imported via tag files and add only the section labels
@@ -8740,15 +8824,12 @@ static void findMainPageTagFiles(EntryNav *rootNav)
 {
   if (rootNav->section() == Entry::MAINPAGEDOC_SEC)
   {
-    rootNav->loadEntry(g_storage);
-
     if (Doxygen::mainPage && rootNav->tagInfo())
     {
       Entry *root = rootNav->entry();
       Doxygen::mainPage->addSectionsToDefinition(root->anchors);
     }
   }
-  RECURSE_ENTRYTREE(findMainPageTagFiles,rootNav);
 }
 
 static void computePageRelations(EntryNav *rootNav)
@@ -8759,7 +8840,6 @@ static void computePageRelations(EntryNav *rootNav)
       && !rootNav->name().isEmpty()
      )
   {
-    rootNav->loadEntry(g_storage);
     Entry *root = rootNav->entry();
 
     PageDef *pd = root->section==Entry::PAGEDOC_SEC ?
@@ -8780,10 +8860,7 @@ static void computePageRelations(EntryNav *rootNav)
         }
       }
     }
-
-    rootNav->releaseEntry();
   }
-  RECURSE_ENTRYTREE(computePageRelations,rootNav);
 }
 
 static void checkPageRelations()
@@ -8902,6 +8979,11 @@ static void generatePageDocs()
 //----------------------------------------------------------------------------
 // create a (sorted) list & dictionary of example pages
 
+static bool isExampleSection(int section)
+{
+  return section==Entry::EXAMPLE_SEC;
+}
+
 static void buildExampleList(EntryNav *rootNav)
 {
   if (rootNav->section()==Entry::EXAMPLE_SEC && !rootNav->name().isEmpty()) 
@@ -8934,7 +9016,6 @@ static void buildExampleList(EntryNav *rootNav)
 
     rootNav->releaseEntry();
   }
-  RECURSE_ENTRYTREE(buildExampleList,rootNav);
 }
 
 //----------------------------------------------------------------------------
@@ -9354,30 +9435,34 @@ static void parseFile(ParserInterface *parser,
   }
 
   QFileInfo fi(fileName);
-  BufStr preBuf(fi.size()+4096);
+  BufStr convBuf(fi.size()+4096);
 
-  if (Config_getBool("ENABLE_PREPROCESSING") && 
-      parser->needsPreprocessing(extension))
   {
-    BufStr inBuf(fi.size()+4096);
-    msg("Preprocessing %s...\n",fn);
-    readInputFile(fileName,inBuf);
-    preprocessFile(fileName,inBuf,preBuf);
-  }
-  else // no preprocessing
-  {
-    msg("Reading %s...\n",fn);
-    readInputFile(fileName,preBuf);
-  }
-  if (preBuf.data() && preBuf.curPos()>0 && *(preBuf.data()+preBuf.curPos()-1)!='\n')
-  {
-    preBuf.addChar('\n'); // add extra newline to help parser
-  }
+    BufStr preBuf(fi.size()+4096);
 
-  BufStr convBuf(preBuf.curPos()+1024);
+    if (Config_getBool("ENABLE_PREPROCESSING") && 
+        parser->needsPreprocessing(extension))
+    {
+      BufStr inBuf(fi.size()+4096);
+      msg("Preprocessing %s...\n",fn);
+      readInputFile(fileName,inBuf);
+      preprocessFile(fileName,inBuf,preBuf);
+    }
+    else // no preprocessing
+    {
+      msg("Reading %s...\n",fn);
+      readInputFile(fileName,preBuf);
+    }
+    if (preBuf.data() && preBuf.curPos()>0 && *(preBuf.data()+preBuf.curPos()-1)!='\n')
+    {
+      preBuf.addChar('\n'); // add extra newline to help parser
+    }
+
+    // convert multi-line C++ comments to C style comments
+    convertCppComments(&preBuf,&convBuf,fileName);
 
-  // convert multi-line C++ comments to C style comments
-  convertCppComments(&preBuf,&convBuf,fileName);
+    // preBuf is freed here, so only convBuf is kept while parsing
+  }
 
   convBuf.addChar('\0');
 
@@ -9395,6 +9480,42 @@ static void parseFile(ParserInterface *parser,
   root->createNavigationIndex(rootNav,g_storage,fd);
 }
 
+#if USE_LIBCLANG
+/*! Runs the preprocessor over the input files only to find their include
+ *  dependencies. The include closures are then available when the files
+ *  that belong to each translation unit are determined.
+ */
+static void findIncludeDependencies()
+{
+  if (!Config_getBool("ENABLE_PREPROCESSING")) return;
+  msg("Finding include dependencies...\n");
+  StringListIterator it(g_inputFiles);
+  QCString *s;
+  for (;(s=it.current());++it)
+  {
+    QCString extension;
+    int ei = s->findRev('.');
+    if (ei!=-1)
+    {
+      extension=s->right(s->length()-ei);
+    }
+    else
+    {
+      extension = ".no_extension";
+    }
+    if (getParserForFile(s->data())->needsPreprocessing(extension))
+    {
+      QFileInfo fi(*s);
+      BufStr inBuf(fi.size()+4096);
+      BufStr outBuf(fi.size()+4096);
+      readInputFile(*s,inBuf);
+      preprocessFile(*s,inBuf,outBuf);
+    }
+  }
+  computeIncludeClosures();
+}
+#endif
+
 //! parse the list of input files
 static void parseFiles(Entry *root,EntryNav *rootNav)
 {
@@ -9402,6 +9523,8 @@ static void parseFiles(Entry *root,EntryNav *rootNav)
   static bool clangAssistedParsing = Config_getBool("CLANG_ASSISTED_PARSING");
   if (clangAssistedParsing)
   {
+    findIncludeDependencies();
+
     QDict<void> g_processedFiles(10007);
 
     // create a dictionary with files to process
@@ -10020,6 +10143,7 @@ void initDoxygen()
   initFileMemberIndices();
 
   Doxygen::symbolMap     = new QDict<DefinitionIntf>(50177);
+  Doxygen::symbolTable   = new SymbolTable;
 #ifdef USE_LIBCLANG
   Doxygen::clangUsrMap   = new QDict<Definition>(50177);
 #endif
@@ -10134,6 +10258,7 @@ void cleanUpDoxygen()
   delete Doxygen::hiddenClasses;
   delete Doxygen::namespaceSDict;
   delete Doxygen::directories;
+  freeInternedStrings();
 
   //delete Doxygen::symbolMap; <- we cannot do this unless all static lists 
   //                              (such as Doxygen::namespaceSDict)
@@ -10692,6 +10817,12 @@ static void writeTagFile()
   */
 
   tagFile << "</tagfile>" << endl;
+  tag.close();
+
+  if (Config_getBool("TAGFILE_CACHE"))
+  {
+    writeTagFileCache(generateTagFile);
+  }
 }
 
 static void exitDoxygen()
@@ -10939,6 +11070,17 @@ void parseInput()
   Doxygen::lookupCache = new QCache<LookupInfo>(lookupSize,lookupSize);
   Doxygen::lookupCache->setAutoDelete(TRUE);
 
+  if (Debug::isFlagSet(Debug::Symbols))
+  {
+    // record the symbol lookups, so they can be replayed by the
+    // SYMTAB_TEST driver in symboltable.cpp
+    QCString recordFile = outputDirectory+"/symbollookups.log";
+    if (!Doxygen::symbolTable->startRecording(recordFile))
+    {
+      err("could not open %s for writing\n",recordFile.data());
+    }
+  }
+
 #ifdef HAS_SIGNALS
   signal(SIGINT, stopDoxygen);
 #endif
@@ -11081,6 +11223,7 @@ void parseInput()
   Entry *root=new Entry;
   EntryNav *rootNav = new EntryNav(0,root);
   rootNav->setEntry(root);
+  rootNav->setSectionIndex(&g_entryNavIndex);
   msg("Reading and parsing tag files\n");
   
   QStrList &tagFileList = Config_getList("TAGFILES");
@@ -11112,6 +11255,10 @@ void parseInput()
   scanFreeScanner();
   pyscanFreeScanner();
 
+  // all include dependencies are known now (with libclang they were
+  // already collected before parsing, see findIncludeDependencies())
+  computeIncludeClosures();
+
   if (!g_storage->open(IO_ReadOnly))
   {
     err("Failed to open temporary storage file %s for reading",
@@ -11124,13 +11271,12 @@ void parseInput()
    **************************************************************************/
 
   g_s.begin("Building group list...\n");
-  buildGroupList(rootNav);
-  organizeSubGroups(rootNav);
+  buildGroups();
   g_s.end();
 
   g_s.begin("Building directory list...\n");
   buildDirectories();
-  findDirDocumentation(rootNav);
+  FOR_EACH_ENTRYNAV(findDirDocumentation,isDirDocSection);
   g_s.end();
 
   g_s.begin("Building namespace list...\n");
@@ -11139,16 +11285,16 @@ void parseInput()
   g_s.end();
 
   g_s.begin("Building file list...\n");
-  buildFileList(rootNav);
+  FOR_EACH_ENTRYNAV(buildFileList,isFileSection);
   g_s.end();
   //generateFileTree();
 
   g_s.begin("Building class list...\n");
-  buildClassList(rootNav);
+  FOR_EACH_ENTRYNAV(buildClassList,isClassDefSection);
   g_s.end();
 
   g_s.begin("Associating documentation with classes...\n");
-  buildClassDocList(rootNav);
+  FOR_EACH_ENTRYNAV(buildClassDocList,isClassDocSection);
 
   // build list of using declarations here (global list)
   buildListOfUsingDecls(rootNav);
@@ -11168,7 +11314,7 @@ void parseInput()
   g_usingDeclarations.clear();
 
   g_s.begin("Building example list...\n");
-  buildExampleList(rootNav);
+  FOR_EACH_ENTRYNAV(buildExampleList,isExampleSection);
   g_s.end();
 
   g_s.begin("Searching for enumerations...\n");
@@ -11210,11 +11356,11 @@ void parseInput()
   g_s.end();
 
   g_s.begin("Searching for documented defines...\n");
-  findDefineDocumentation(rootNav);
+  FOR_EACH_ENTRYNAV(findDefineDocumentation,isDefineSection);
   g_s.end();
 
   g_s.begin("Computing class inheritance relations...\n");
-  findClassEntries(rootNav);
+  FOR_EACH_ENTRYNAV(findClassEntries,isClassOrClassDocSection);
   findInheritedTemplateInstances();
   g_s.end();
 
@@ -11250,7 +11396,7 @@ void parseInput()
 
   g_s.begin("Add enum values to enums...\n");
   addEnumValuesToEnums(rootNav);
-  findEnumDocumentation(rootNav);
+  FOR_EACH_ENTRYNAV(findEnumDocumentation,isEnumDocSection);
   g_s.end();
 
   g_s.begin("Searching for member function documentation...\n");
@@ -11261,22 +11407,29 @@ void parseInput()
   transferFunctionDocumentation();
   g_s.end();
 
+  // the page passes depend on each other's results, but they share
+  // the page entries, which are loaded only once
+  EntryNavList pageNavs;
+  loadEntries(pageNavs,isPageOrMainPageDocSection);
+
   g_s.begin("Building page list...\n");
-  buildPageList(rootNav);
+  forEachEntryNav(pageNavs,buildPageList);
   g_s.end();
 
   g_s.begin("Search for main page...\n");
-  findMainPage(rootNav);
-  findMainPageTagFiles(rootNav);
+  forEachEntryNav(pageNavs,findMainPage);
+  forEachEntryNav(pageNavs,findMainPageTagFiles);
   g_s.end();
 
   g_s.begin("Computing page relations...\n");
-  computePageRelations(rootNav);
+  forEachEntryNav(pageNavs,computePageRelations);
   checkPageRelations();
   g_s.end();
 
+  releaseEntries(pageNavs);
+
   g_s.begin("Determining the scope of groups...\n");
-  findGroupScope(rootNav);
+  FOR_EACH_ENTRYNAV(findGroupScope,isGroupSection);
   g_s.end();
 
   g_s.begin("Sorting lists...\n");
@@ -11386,6 +11539,10 @@ void parseInput()
   g_s.begin("Adding members to index pages...\n");
   addMembersToIndex();
   g_s.end();
+
+  // from here on the relations between symbols no longer change,
+  // so the outcome of the accessibility checks can be cached.
+  initAccessibilityCache(lookupSize);
 }
 
 void generateOutput()
@@ -11664,6 +11821,9 @@ void generateOutput()
     g_s.end();
   }
 
+  // convert the PlantUML diagrams collected while writing the output
+  PlantumlManager::instance()->run();
+
   if (generateHtml &&
       Config_getBool("GENERATE_HTMLHELP") && 
       !Config_getString("HHC_LOCATION").isEmpty())
@@ -11707,6 +11867,11 @@ void generateOutput()
       Doxygen::lookupCache->size(),
       Doxygen::lookupCache->hits(),
       Doxygen::lookupCache->misses());
+  printAccessibilityCacheStats();
+  if (Debug::isFlagSet(Debug::Symbols))
+  {
+    Doxygen::symbolTable->printStats();
+  }
   cacheParam = computeIdealCacheParam(Doxygen::lookupCache->misses()*2/3); // part of the cache is flushed, hence the 2/3 correction factor
   if (cacheParam>Config_getInt("LOOKUP_CACHE_SIZE"))
   {
@@ -11740,6 +11905,8 @@ void generateOutput()
   Config::deleteInstance();
   QTextCodec::deleteAllCodecs();
   delete Doxygen::symbolMap;
+  delete Doxygen::symbolTable;
+  Doxygen::symbolTable = 0;
   delete Doxygen::clangUsrMap;
   delete Doxygen::symbolStorage;
   g_successfulRun=TRUE;
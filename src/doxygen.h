@@ -55,6 +55,7 @@ class FileNameList;
 class NamespaceSDict;
 class NamespaceDef;
 class DefinitionIntf;
+class SymbolTable;
 class DirSDict;
 class DirRelation;
 class IndexList;
@@ -132,6 +133,7 @@ class Doxygen
     static QTime                     runningTime;
     static SearchIndexIntf          *searchIndex;
     static QDict<DefinitionIntf>    *symbolMap;
+    static SymbolTable              *symbolTable;
     static QDict<Definition>        *clangUsrMap;
     static bool                      outputToWizard;
     static QDict<int>               *htmlDirMap;
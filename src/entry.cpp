@@ -331,7 +331,8 @@ Entry *Entry::removeSubEntry(Entry *e)
 EntryNav::EntryNav(EntryNav *parent, Entry *e)
              : m_parent(parent), m_subList(0), m_section(e->section), m_type(e->type),
               m_name(e->name), m_fileDef(0), m_lang(e->lang), 
-              m_info(0), m_offset(-1), m_noLoad(FALSE) 
+              m_info(0), m_offset(-1), m_noLoad(FALSE),
+              m_index(parent ? parent->m_index : 0), m_order(-1)
 {
   if (e->tagInfo)
   {
@@ -369,6 +370,7 @@ void EntryNav::addChild(EntryNav *e)
     m_subList->setAutoDelete(TRUE);
   }
   m_subList->append(e);
+  if (m_index) m_index->add(e);
 }
 
 bool EntryNav::loadEntry(FileStorage *storage)
@@ -396,8 +398,13 @@ bool EntryNav::loadEntry(FileStorage *storage)
     //printf("seek failed!\n");
     return FALSE;
   }
+  static RecordBuffer record;
+  if (!record.readRecord(storage))
+  {
+    return FALSE;
+  }
   if (m_info)  delete m_info;
-  m_info = unmarshalEntry(storage);
+  m_info = unmarshalEntry(&record);
   m_info->name = m_name;
   m_info->type = m_type;
   m_info->section = m_section;
@@ -408,7 +415,11 @@ bool EntryNav::saveEntry(Entry *e,FileStorage *storage)
 {
   m_offset = storage->pos();
   //printf("EntryNav::saveEntry offset=%llx\n",m_offset);
-  marshalEntry(storage,e);
+  // collect the entry in memory, so it is written with a single call
+  static RecordBuffer record;
+  record.clear();
+  marshalEntry(&record,e);
+  record.writeRecord(storage);
   return TRUE;
 }
 
@@ -430,3 +441,65 @@ void EntryNav::setEntry(Entry *e)
   m_noLoad=TRUE; 
 }
 
+//------------------------------------------------------------------
+
+EntryNavIndex::EntryNavIndex() : m_sections(257), m_count(0)
+{
+  m_sections.setAutoDelete(TRUE);
+}
+
+void EntryNavIndex::add(EntryNav *nav)
+{
+  EntryNavList *list = m_sections.find(nav->section());
+  if (list==0)
+  {
+    list = new EntryNavList;
+    m_sections.insert(nav->section(),list);
+  }
+  nav->m_order = m_count++;
+  list->append(nav);
+}
+
+static int compareEntryNavOrder(const void *p1,const void *p2)
+{
+  int o1 = (*(EntryNav * const *)p1)->order();
+  int o2 = (*(EntryNav * const *)p2)->order();
+  return o1<o2 ? -1 : o1>o2 ? 1 : 0;
+}
+
+void EntryNavIndex::findSections(EntryNavList &result,bool (*match)(int section)) const
+{
+  QIntDictIterator<EntryNavList> it(m_sections);
+  EntryNavList *list;
+  QList<EntryNavList> matches;
+  uint total=0;
+  for (;(list=it.current());++it)
+  {
+    if (match((int)it.currentKey()))
+    {
+      matches.append(list);
+      total+=list->count();
+    }
+  }
+  if (matches.count()==1) // already in tree order
+  {
+    EntryNavListIterator eli(*matches.getFirst());
+    EntryNav *e;
+    for (;(e=eli.current());++eli) result.append(e);
+  }
+  else if (total>0) // merge the lists of the different sections
+  {
+    EntryNav **nodes = new EntryNav*[total];
+    uint i=0;
+    QListIterator<EntryNavList> mli(matches);
+    for (;(list=mli.current());++mli)
+    {
+      EntryNavListIterator eli(*list);
+      EntryNav *e;
+      for (;(e=eli.current());++eli) nodes[i++]=e;
+    }
+    qsort(nodes,total,sizeof(EntryNav*),compareEntryNavOrder);
+    for (i=0;i<total;i++) result.append(nodes[i]);
+    delete[] nodes;
+  }
+}
@@ -21,11 +21,13 @@
 #include "types.h"
 
 #include <qlist.h>
+#include <qintdict.h>
 #include <qgstring.h>
 
 struct SectionInfo;
 class QFile;
 class EntryNav;
+class EntryNavIndex;
 class FileDef;
 class FileStorage;
 class StorageIntf;
@@ -342,6 +344,7 @@ class EntryNav
     void releaseEntry();
     void changeSection(int section) { m_section = section; }
     void setFileDef(FileDef *fd) { m_fileDef = fd; }
+    void setSectionIndex(EntryNavIndex *index) { m_index = index; }
 
     Entry *entry() const { return m_info; }
     int section() const { return m_section; }
@@ -352,8 +355,10 @@ class EntryNav
     const QList<EntryNav> *children() const { return m_subList; }
     EntryNav *parent() const { return m_parent; }
     FileDef *fileDef() const { return m_fileDef; }
+    int order() const { return m_order; }
 
   private:
+    friend class EntryNavIndex;
 
     // navigation 
     EntryNav        *m_parent;    //!< parent node in the tree
@@ -370,6 +375,10 @@ class EntryNav
     Entry       *m_info;
     int64        m_offset;
     bool         m_noLoad;
+
+    // section index
+    EntryNavIndex *m_index;     //!< index the children are added to
+    int          m_order;       //!< position in the tree (pre-order)
 };
 
 
@@ -379,4 +388,28 @@ typedef QListIterator<Entry> EntryListIterator;
 typedef QList<EntryNav> EntryNavList;
 typedef QListIterator<EntryNav> EntryNavListIterator;
 
+/** Index of the nodes of an EntryNav tree by section.
+ *
+ *  Nodes are registered by EntryNav::addChild(), not by
+ *  Entry::createNavigationIndex(), so nodes that are added to the tree
+ *  later on are indexed as well. While the tree is built this happens in
+ *  tree order, so a pass that only handles a few kinds of entries can
+ *  visit them in the same order as a recursive walk over the whole tree
+ *  would, without visiting any of the other nodes. A node is indexed
+ *  with the section it had when it was added.
+ */
+class EntryNavIndex
+{
+  public:
+    EntryNavIndex();
+    void add(EntryNav *nav);
+    /*! Appends to \a result all nodes registered with a section for which
+     *  \a match returns TRUE, in tree order.
+     */
+    void findSections(EntryNavList &result,bool (*match)(int section)) const;
+  private:
+    QIntDict<EntryNavList> m_sections;
+    int m_count;
+};
+
 #endif
@@ -15,6 +15,8 @@
  *
  */
 
+#include <qptrdict.h>
+
 #include "memberlist.h"
 #include "classlist.h"
 #include "filedef.h"
@@ -44,6 +46,15 @@
 #include "clangparser.h"
 #include "settings.h"
 
+class IncludeClosures;
+static void invalidateIncludeClosures();
+
+// set by computeIncludeClosures() once the include dependencies are known;
+// dependencies added later only invalidate the closures
+static bool g_includeGraphComplete = FALSE;
+// the closures, built on first use once the include graph is complete
+static IncludeClosures *g_includeClosures = 0;
+
 //---------------------------------------------------------------------------
 
 /** Class implementing CodeOutputInterface by throwing away everything. */
@@ -112,6 +123,7 @@ FileDef::FileDef(const char *p,const char *nm,
 /*! destroy the file definition */
 FileDef::~FileDef()
 {
+  invalidateIncludeClosures();
   delete m_classSDict;
   delete m_includeDict;
   delete m_includeList;
@@ -1287,6 +1299,7 @@ void FileDef::addIncludeDependency(FileDef *fd,const char *incName,bool local,
     ii->indirect    = indirect;
     m_includeList->append(ii);
     m_includeDict->insert(iName,ii);
+    invalidateIncludeClosures();
   }
 }
 
@@ -1879,8 +1892,249 @@ bool FileDef::isLinkableInProject() const
   return hasDocumentation() && !isReference() && showFiles;
 }
 
+/** @brief Transitive include relations between the input files.
+ *
+ *  Files that include each other, directly or via other files, form a
+ *  strongly connected component and share one closure. The closure of a
+ *  component is a bit set over the file indexes, computed on first use 
+ *  from the closures of the components it includes. Closures are kept 
+ *  for both the include and the included-by direction.
+ */
+class IncludeClosures
+{
+  public:
+    IncludeClosures();
+   ~IncludeClosures();
+    /** Returns the closure of \a fd as a bit set over the file indexes,
+     *  or 0 if \a fd is not an input file.
+     */
+    const uint *closure(const FileDef *fd,bool inverse);
+    int numFiles() const              { return m_numFiles; }
+    int numWords() const              { return m_numWords; }
+    FileDef *file(int index) const    { return m_files[index]; }
+    static int count(const uint *bits,int numWords);
+
+  private:
+    int fileIndex(const FileDef *fd) const;
+    QList<IncludeInfo> *edges(const FileDef *fd,bool inverse) const;
+    void findComponents(int v);
+    const uint *componentClosure(int comp,bool inverse);
+
+    int        m_numFiles;
+    int        m_numWords;    // size of a bit set
+    FileDef  **m_files;       // indexed by file index
+    QPtrDict<void> m_index;   // FileDef -> file index+1
+    int       *m_component;   // file index -> component
+    int       *m_members;     // file indexes ordered by component
+    int       *m_firstMember; // component -> first entry in m_members
+    bool      *m_cyclic;      // component -> files include themselves
+    int        m_numComponents;
+    uint     **m_closures[2]; // component -> bit set, per direction
+    // state of Tarjan's algorithm
+    int       *m_order;
+    int       *m_low;
+    int       *m_stack;
+    int        m_stackSize;
+    int        m_counter;
+};
+
+IncludeClosures::IncludeClosures() : m_index(1009)
+{
+  m_numFiles=0;
+  FileNameListIterator fnli(*Doxygen::inputNameList);
+  FileName *fn;
+  for (fnli.toFirst();(fn=fnli.current());++fnli)
+  {
+    m_numFiles+=fn->count();
+  }
+  m_numWords = (m_numFiles+31)/32;
+  m_files = new FileDef*[m_numFiles];
+  m_index.resize(m_numFiles*2+1);
+  int i=0;
+  for (fnli.toFirst();(fn=fnli.current());++fnli)
+  {
+    FileNameIterator fni(*fn);
+    FileDef *fd;
+    for (;(fd=fni.current());++fni)
+    {
+      m_files[i]=fd;
+      m_index.insert(fd,(void*)(long)(i+1));
+      i++;
+    }
+  }
+
+  // find the strongly connected components, Tarjan's algorithm
+  m_component   = new int[m_numFiles];
+  m_members     = new int[m_numFiles];
+  m_firstMember = new int[m_numFiles+1];
+  m_cyclic      = new bool[m_numFiles];
+  m_order       = new int[m_numFiles];
+  m_low         = new int[m_numFiles];
+  m_stack       = new int[m_numFiles];
+  m_stackSize=0;
+  m_counter=0;
+  m_numComponents=0;
+  for (i=0;i<m_numFiles;i++) m_order[i]=m_component[i]=-1;
+  for (i=0;i<m_numFiles;i++)
+  {
+    if (m_order[i]==-1) findComponents(i);
+  }
+  // list the files of each component together
+  for (i=0;i<=m_numComponents;i++) m_firstMember[i]=0;
+  for (i=0;i<m_numFiles;i++) m_firstMember[m_component[i]+1]++;
+  for (i=0;i<m_numComponents;i++) m_firstMember[i+1]+=m_firstMember[i];
+  for (i=0;i<m_numComponents;i++) m_low[i]=m_firstMember[i]; // insert position
+  for (i=0;i<m_numFiles;i++) m_members[m_low[m_component[i]]++]=i;
+  delete[] m_order; m_order=0;
+  delete[] m_low;   m_low=0;
+  delete[] m_stack; m_stack=0;
+
+  int d;
+  for (d=0;d<2;d++)
+  {
+    m_closures[d] = new uint*[m_numComponents];
+    for (i=0;i<m_numComponents;i++) m_closures[d][i]=0;
+  }
+}
+
+IncludeClosures::~IncludeClosures()
+{
+  int d,i;
+  for (d=0;d<2;d++)
+  {
+    for (i=0;i<m_numComponents;i++) delete[] m_closures[d][i];
+    delete[] m_closures[d];
+  }
+  delete[] m_files;
+  delete[] m_component;
+  delete[] m_members;
+  delete[] m_firstMember;
+  delete[] m_cyclic;
+}
+
+int IncludeClosures::fileIndex(const FileDef *fd) const
+{
+  return (int)(long)m_index.find((void*)fd)-1;
+}
+
+/** Returns the includes of \a fd, or the files including \a fd 
+ *  if \a inverse is TRUE.
+ */
+QList<IncludeInfo> *IncludeClosures::edges(const FileDef *fd,bool inverse) const
+{
+  return inverse ? fd->includedByFileList() : fd->includeFileList();
+}
+
+void IncludeClosures::findComponents(int v)
+{
+  m_order[v]=m_low[v]=m_counter++;
+  m_stack[m_stackSize++]=v;
+  bool selfInclude=FALSE;
+  QList<IncludeInfo> *il = edges(m_files[v],FALSE);
+  if (il)
+  {
+    QListIterator<IncludeInfo> iii(*il);
+    IncludeInfo *ii;
+    for (iii.toFirst();(ii=iii.current());++iii)
+    {
+      int w = ii->fileDef && !ii->fileDef->isReference() ? fileIndex(ii->fileDef) : -1;
+      if (w==-1) continue;
+      if (w==v)
+      {
+        selfInclude=TRUE;
+      }
+      else if (m_order[w]==-1) // not visited yet
+      {
+        findComponents(w);
+        m_low[v]=QMIN(m_low[v],m_low[w]);
+      }
+      else if (m_component[w]==-1) // w is on the stack
+      {
+        m_low[v]=QMIN(m_low[v],m_order[w]);
+      }
+    }
+  }
+  if (m_low[v]==m_order[v]) // v is the root of a component
+  {
+    int comp = m_numComponents++;
+    int n=0,w;
+    do
+    {
+      w=m_stack[--m_stackSize];
+      m_component[w]=comp;
+      n++;
+    } while (w!=v);
+    m_cyclic[comp] = n>1 || selfInclude;
+  }
+}
+
+const uint *IncludeClosures::componentClosure(int comp,bool inverse)
+{
+  uint *&bits = m_closures[inverse?1:0][comp];
+  if (bits) return bits;
+  bits = new uint[m_numWords];
+  memset(bits,0,m_numWords*sizeof(uint));
+  int i,j;
+  for (i=m_firstMember[comp];i<m_firstMember[comp+1];i++)
+  {
+    int v = m_members[i];
+    if (m_cyclic[comp]) bits[v>>5]|=1u<<(v&31);
+    QList<IncludeInfo> *il = edges(m_files[v],inverse);
+    if (il)
+    {
+      QListIterator<IncludeInfo> iii(*il);
+      IncludeInfo *ii;
+      for (iii.toFirst();(ii=iii.current());++iii)
+      {
+        int w = ii->fileDef && !ii->fileDef->isReference() ? fileIndex(ii->fileDef) : -1;
+        if (w==-1 || m_component[w]==comp) continue;
+        bits[w>>5]|=1u<<(w&31);
+        const uint *wbits = componentClosure(m_component[w],inverse);
+        for (j=0;j<m_numWords;j++) bits[j]|=wbits[j];
+      }
+    }
+  }
+  return bits;
+}
+
+const uint *IncludeClosures::closure(const FileDef *fd,bool inverse)
+{
+  int v = fileIndex(fd);
+  return v==-1 ? 0 : componentClosure(m_component[v],inverse);
+}
+
+int IncludeClosures::count(const uint *bits,int numWords)
+{
+  int n=0,i;
+  for (i=0;i<numWords;i++)
+  {
+    uint w=bits[i];
+    while (w) { w&=w-1; n++; }
+  }
+  return n;
+}
+
+static IncludeClosures *includeClosures()
+{
+  if (!g_includeGraphComplete) return 0;
+  if (g_includeClosures==0) g_includeClosures = new IncludeClosures;
+  return g_includeClosures;
+}
+
+static void invalidateIncludeClosures()
+{
+  delete g_includeClosures;
+  g_includeClosures=0;
+}
+
+void computeIncludeClosures()
+{
+  g_includeGraphComplete=TRUE;
+  invalidateIncludeClosures();
+}
+
 static void getAllIncludeFilesRecursively(
-    QDict<void> *filesVisited,const FileDef *fd,QStrList &incFiles)
+    QPtrDict<void> *filesVisited,const FileDef *fd,QStrList &incFiles)
 {
   if (fd->includeFileList())
   {
@@ -1889,21 +2143,53 @@ static void getAllIncludeFilesRecursively(
     for (iii.toFirst();(ii=iii.current());++iii)
     {
       if (ii->fileDef && !ii->fileDef->isReference() &&
-          !filesVisited->find(ii->fileDef->absFilePath()))
+          !filesVisited->find(ii->fileDef))
       {
         //printf("FileDef::addIncludeDependency(%s)\n",ii->fileDef->absFilePath().data());
         incFiles.append(ii->fileDef->absFilePath());
-        filesVisited->insert(ii->fileDef->absFilePath(),(void*)0x8);
+        filesVisited->insert(ii->fileDef,(void*)0x8);
         getAllIncludeFilesRecursively(filesVisited,ii->fileDef,incFiles);
       }
     }
   }
 }
 
+/*! Appends the files included directly or indirectly by this file to 
+ *  \a incFiles. After computeIncludeClosures() the precomputed closure
+ *  is used and the files are returned in input order; before that the
+ *  graph is walked depth first.
+ */
 void FileDef::getAllIncludeFilesRecursively(QStrList &incFiles) const
 {
-  QDict<void> includes(257);
-  ::getAllIncludeFilesRecursively(&includes,this,incFiles);
+  IncludeClosures *ic = includeClosures();
+  const uint *bits = ic ? ic->closure(this,FALSE) : 0;
+  if (bits)
+  {
+    int i;
+    for (i=0;i<ic->numWords();i++)
+    {
+      uint w = bits[i];
+      int index = i*32;
+      while (w) // only visit the bits that are set
+      {
+        while ((w&0xff)==0) { w>>=8; index+=8; }
+        if (w&1) incFiles.append(ic->file(index)->absFilePath());
+        w>>=1; index++;
+      }
+    }
+  }
+  else
+  {
+    QPtrDict<void> includes(257);
+    ::getAllIncludeFilesRecursively(&includes,this,incFiles);
+  }
+}
+
+int FileDef::numIncludeFilesRecursively(bool inverse) const
+{
+  IncludeClosures *ic = includeClosures();
+  const uint *bits = ic ? ic->closure(this,inverse) : 0;
+  return bits ? IncludeClosures::count(bits,ic->numWords()) : -1;
 }
 
 QCString FileDef::title() const
@@ -124,6 +124,11 @@ class FileDef : public Definition
     QList<IncludeInfo> *includeFileList() const    { return m_includeList; }
     QList<IncludeInfo> *includedByFileList() const { return m_includedByList; }
     void getAllIncludeFilesRecursively(QStrList &incFiles) const;
+    /*! Returns the number of files included by this file directly or 
+     *  indirectly, or the number of files including it if \a inverse is 
+     *  TRUE. Returns -1 before computeIncludeClosures() has been called.
+     */
+    int numIncludeFilesRecursively(bool inverse) const;
 
     MemberList *getMemberList(MemberListType lt) const;
     const QList<MemberList> &getMemberLists() const { return m_memberLists; }
@@ -320,6 +325,7 @@ class Directory : public DirEntry
 };
 
 void generateFileTree();
+void computeIncludeClosures();
 
 #endif
 
@@ -21,6 +21,8 @@
 #include <qfileinfo.h>
 #include <qtextstream.h>
 #include <qdir.h>
+#include <qthread.h>
+#include <qmutex.h>
 
 #include "formula.h"
 #include "image.h"
@@ -48,9 +50,251 @@ int Formula::getId()
   return number;
 }
 
+/*! Converts page \a pageIndex of _formulas.dvi into the image 
+ *  form_<pageNum>.png, using dvips and ghostscript. The image is 
+ *  rendered \a scaleFactor times larger than the postscript and then 
+ *  down-sampled. Returns FALSE if one of the tools could not be run.
+ */
+static bool generateFormulaImage(int pageNum,int pageIndex,double scaleFactor)
+{
+  int x1=0,y1=0,x2=0,y2=0;
+  QFile f;
+  char dviArgs[4096];
+  QCString formBase;
+  formBase.sprintf("_form%d",pageNum);
+  // run dvips to convert the page with number pageIndex to an
+  // encapsulated postscript.
+  sprintf(dviArgs,"-q -D 600 -E -n 1 -p %d -o %s.eps _formulas.dvi",
+      pageIndex,formBase.data());
+  if (portable_system("dvips",dviArgs)!=0)
+  {
+    err("Problems running dvips. Check your installation!\n");
+    return FALSE;
+  }
+  // now we read the generated postscript file to extract the bounding box
+  QFileInfo fi(formBase+".eps");
+  if (fi.exists())
+  {
+    QCString eps = fileToString(formBase+".eps");
+    int i=eps.find("%%BoundingBox:");
+    if (i!=-1)
+    {
+      sscanf(eps.data()+i,"%%%%BoundingBox:%d %d %d %d",&x1,&y1,&x2,&y2);
+    }
+    else
+    {
+      err("Couldn't extract bounding box!\n");
+    }
+  } 
+  // next we generate a postscript file which contains the eps
+  // and displays it in the right colors and the right bounding box
+  f.setName(formBase+".ps");
+  if (f.open(IO_WriteOnly))
+  {
+    FTextStream t(&f);
+    t << "1 1 1 setrgbcolor" << endl;  // anti-alias to white background
+    t << "newpath" << endl;
+    t << "-1 -1 moveto" << endl;
+    t << (x2-x1+2) << " -1 lineto" << endl;
+    t << (x2-x1+2) << " " << (y2-y1+2) << " lineto" << endl;
+    t << "-1 " << (y2-y1+2) << " lineto" <<endl;
+    t << "closepath" << endl;
+    t << "fill" << endl;
+    t << -x1 << " " << -y1 << " translate" << endl;
+    t << "0 0 0 setrgbcolor" << endl;
+    t << "(" << formBase << ".eps) run" << endl;
+    f.close();
+  }
+  // scale the image so that it is four times larger than needed.
+  // and the sizes are a multiple of four (see scaleFactor).
+  int gx = (((int)((x2-x1)*scaleFactor))+3)&~1;
+  int gy = (((int)((y2-y1)*scaleFactor))+3)&~1;
+  // Then we run ghostscript to convert the postscript to a pixmap
+  // The pixmap is a truecolor image, where only black and white are
+  // used.  
+
+  char gsArgs[4096];
+  sprintf(gsArgs,"-q -g%dx%d -r%dx%dx -sDEVICE=ppmraw "
+                "-sOutputFile=%s.pnm -dNOPAUSE -dBATCH -- %s.ps",
+                gx,gy,(int)(scaleFactor*72),(int)(scaleFactor*72),
+                formBase.data(),formBase.data()
+         );
+  if (portable_system(portable_ghostScriptCommand(),gsArgs)!=0)
+  {
+    err("Problem running ghostscript %s %s. Check your installation!\n",portable_ghostScriptCommand(),gsArgs);
+    return FALSE;
+  }
+  f.setName(formBase+".pnm");
+  uint imageX=0,imageY=0;
+  // we read the generated image again, to obtain the pixel data.
+  if (f.open(IO_ReadOnly))
+  {
+    QTextStream t(&f);
+    QCString s;
+    if (!t.eof())
+      s=t.readLine().utf8();
+    if (s.length()<2 || s.left(2)!="P6")
+      err("ghostscript produced an illegal image format!");
+    else
+    {
+      // assume the size is after the first line that does not start with
+      // # excluding the first line of the file.
+      while (!t.eof() && (s=t.readLine().utf8()) && !s.isEmpty() && s.at(0)=='#') { }
+      sscanf(s,"%d %d",&imageX,&imageY);
+    }
+    if (imageX>0 && imageY>0)
+    {
+      //printf("Converting image...\n");
+      char *data = new char[imageX*imageY*3]; // rgb 8:8:8 format
+      uint i,x,y,ix,iy;
+      f.readBlock(data,imageX*imageY*3);
+      Image srcImage(imageX,imageY),
+            filteredImage(imageX,imageY),
+            dstImage(imageX/4,imageY/4);
+      uchar *ps=srcImage.getData();
+      // convert image to black (1) and white (0) index.
+      for (i=0;i<imageX*imageY;i++) *ps++= (data[i*3]==0 ? 1 : 0);
+      // apply a simple box filter to the image 
+      static int filterMask[]={1,2,1,2,8,2,1,2,1};
+      for (y=0;y<srcImage.getHeight();y++)
+      {
+        for (x=0;x<srcImage.getWidth();x++)
+        {
+          int s=0;
+          for (iy=0;iy<2;iy++)
+          {
+            for (ix=0;ix<2;ix++)
+            {
+              s+=srcImage.getPixel(x+ix-1,y+iy-1)*filterMask[iy*3+ix];
+            }
+          }
+          filteredImage.setPixel(x,y,s);
+        }
+      }
+      // down-sample the image to 1/16th of the area using 16 gray scale
+      // colors.
+      // TODO: optimize this code.
+      for (y=0;y<dstImage.getHeight();y++)
+      {
+        for (x=0;x<dstImage.getWidth();x++)
+        {
+          int xp=x<<2;
+          int yp=y<<2;
+          int c=filteredImage.getPixel(xp+0,yp+0)+
+                filteredImage.getPixel(xp+1,yp+0)+
+                filteredImage.getPixel(xp+2,yp+0)+
+                filteredImage.getPixel(xp+3,yp+0)+
+                filteredImage.getPixel(xp+0,yp+1)+
+                filteredImage.getPixel(xp+1,yp+1)+
+                filteredImage.getPixel(xp+2,yp+1)+
+                filteredImage.getPixel(xp+3,yp+1)+
+                filteredImage.getPixel(xp+0,yp+2)+
+                filteredImage.getPixel(xp+1,yp+2)+
+                filteredImage.getPixel(xp+2,yp+2)+
+                filteredImage.getPixel(xp+3,yp+2)+
+                filteredImage.getPixel(xp+0,yp+3)+
+                filteredImage.getPixel(xp+1,yp+3)+
+                filteredImage.getPixel(xp+2,yp+3)+
+                filteredImage.getPixel(xp+3,yp+3);
+          // here we scale and clip the color value so the
+          // resulting image has a reasonable contrast
+          dstImage.setPixel(x,y,QMIN(15,(c*15)/(16*10)));
+        }
+      }
+      // save the result as a bitmap
+      QCString resultName;
+      resultName.sprintf("form_%d.png",pageNum);
+      // the option parameter 1 is used here as a temporary hack
+      // to select the right color palette! 
+      dstImage.save(resultName,1);
+      delete[] data;
+    }
+    f.close();
+  } 
+  // remove intermediate image files
+  QDir().remove(formBase+".eps");
+  QDir().remove(formBase+".pnm");
+  QDir().remove(formBase+".ps");
+  return TRUE;
+}
+
+/** Queue of the formula images that still need to be generated, 
+ *  shared by the threads running dvips and ghostscript.
+ */
+class FormulaJobQueue
+{
+  public:
+    FormulaJobQueue(const QList<int> &pages) : m_pages(pages), m_next(0), m_failed(FALSE) {}
+    /*! Returns the next page to convert in \a pageNum and its position 
+     *  in the dvi file in \a pageIndex. Returns FALSE if there are no 
+     *  more pages, or a tool failed to run.
+     */
+    bool next(int &pageNum,int &pageIndex)
+    {
+      QMutexLocker locker(&m_mutex);
+      if (m_failed || m_next>=m_pages.count()) return FALSE;
+      pageNum   = *m_pages.at(m_next);
+      pageIndex = ++m_next;
+      msg("Generating image form_%d.png for formula\n",pageNum);
+      return TRUE;
+    }
+    void setFailed()
+    {
+      QMutexLocker locker(&m_mutex);
+      m_failed=TRUE;
+    }
+    bool failed() const { return m_failed; }
+  private:
+    const QList<int> &m_pages;
+    uint   m_next;
+    bool   m_failed;
+    QMutex m_mutex;
+};
+
+/** Worker thread generating formula images from a FormulaJobQueue */
+class FormulaWorkerThread : public QThread
+{
+  public:
+    FormulaWorkerThread(FormulaJobQueue *queue,double scaleFactor) 
+      : m_queue(queue), m_scaleFactor(scaleFactor) {}
+    void run()
+    {
+      int pageNum,pageIndex;
+      while (m_queue->next(pageNum,pageIndex))
+      {
+        if (!generateFormulaImage(pageNum,pageIndex,m_scaleFactor))
+        {
+          m_queue->setFailed();
+        }
+      }
+    }
+  private:
+    FormulaJobQueue *m_queue;
+    double m_scaleFactor;
+};
+
+/*! Returns a description of the settings that influence the formula images,
+ *  so images made with different settings are not reused.
+ */
+static QCString formulaSettings()
+{
+  QCString result;
+  result.sprintf("fontsize=%d transparent=%d latex=",
+      Config_getInt("FORMULA_FONTSIZE"),Config_getBool("FORMULA_TRANSPARENT"));
+  result+=Config_getString("LATEX_CMD_NAME");
+  result+=" packages=";
+  const char *s=Config_getList("EXTRA_PACKAGES").first();
+  while (s)
+  {
+    result+=s;
+    result+=",";
+    s=Config_getList("EXTRA_PACKAGES").next();
+  }
+  return result;
+}
+
 void FormulaList::generateBitmaps(const char *path)
 {
-  int x1,y1,x2,y2;
   QDir d(path);
   // store the original directory
   if (!d.exists()) { err("Output dir %s does not exist!\n",path); exit(1); }
@@ -58,6 +302,10 @@ void FormulaList::generateBitmaps(const char *path)
   // go to the html output directory (i.e. path)
   QDir::setCurrent(d.absPath());
   QDir thisDir;
+  // images made with different settings cannot be reused
+  QCString settings = formulaSettings();
+  bool settingsChanged = QFileInfo("formula.settings").exists() &&
+                         fileToString("formula.settings").stripWhiteSpace()!=settings;
   // generate a latex file containing one formula per page.
   QCString texName="_formulas.tex";
   QList<int> pagesToGenerate;
@@ -87,7 +335,7 @@ void FormulaList::generateBitmaps(const char *path)
       resultName.sprintf("form_%d.png",formula->getId());
       // only formulas for which no image exists are generated
       QFileInfo fi(resultName);
-      if (!fi.exists())
+      if (!fi.exists() || settingsChanged)
       {
         // we force a pagebreak after each formula
         t << formula->getFormulaText() << endl << "\\pagebreak\n\n";
@@ -114,180 +362,52 @@ void FormulaList::generateBitmaps(const char *path)
       //return;
     }
     portable_sysTimerStop();
-    //printf("Running dvips...\n");
-    QListIterator<int> pli(pagesToGenerate);
-    int *pagePtr;
-    int pageIndex=1;
-    for (;(pagePtr=pli.current());++pli,++pageIndex)
+
+    double scaleFactor = 16.0/3.0; 
+    int zoomFactor = Config_getInt("FORMULA_FONTSIZE");
+    if (zoomFactor<8 || zoomFactor>50) zoomFactor=10;
+    scaleFactor *= zoomFactor/10.0;
+
+    // the pages are independent, so run dvips and ghostscript for several
+    // pages in parallel, using the same number of threads as for dot.
+    FormulaJobQueue queue(pagesToGenerate);
+    QList<FormulaWorkerThread> workers;
+    workers.setAutoDelete(TRUE);
+    int numThreads = QMIN(32,Config_getInt("DOT_NUM_THREADS"));
+    if (numThreads==0) numThreads = QMAX(2,QThread::idealThreadCount()+1);
+    numThreads = QMIN(numThreads,(int)pagesToGenerate.count());
+    portable_sysTimerStart();
+    if (numThreads>1)
     {
-      int pageNum=*pagePtr;
-      msg("Generating image form_%d.png for formula\n",pageNum);
-      char dviArgs[4096];
-      QCString formBase;
-      formBase.sprintf("_form%d",pageNum);
-      // run dvips to convert the page with number pageIndex to an
-      // encapsulated postscript.
-      sprintf(dviArgs,"-q -D 600 -E -n 1 -p %d -o %s.eps _formulas.dvi",
-          pageIndex,formBase.data());
-      portable_sysTimerStart();
-      if (portable_system("dvips",dviArgs)!=0)
+      int i;
+      for (i=0;i<numThreads;i++)
       {
-        err("Problems running dvips. Check your installation!\n");
-        portable_sysTimerStop();
-        return;
-      }
-      portable_sysTimerStop();
-      // now we read the generated postscript file to extract the bounding box
-      QFileInfo fi(formBase+".eps");
-      if (fi.exists())
-      {
-        QCString eps = fileToString(formBase+".eps");
-        int i=eps.find("%%BoundingBox:");
-        if (i!=-1)
+        FormulaWorkerThread *thread = new FormulaWorkerThread(&queue,scaleFactor);
+        thread->start();
+        if (thread->isRunning())
         {
-          sscanf(eps.data()+i,"%%%%BoundingBox:%d %d %d %d",&x1,&y1,&x2,&y2);
+          workers.append(thread);
         }
-        else
+        else // no more threads available!
         {
-          err("Couldn't extract bounding box!\n");
+          delete thread;
         }
-      } 
-      // next we generate a postscript file which contains the eps
-      // and displays it in the right colors and the right bounding box
-      f.setName(formBase+".ps");
-      if (f.open(IO_WriteOnly))
-      {
-        FTextStream t(&f);
-        t << "1 1 1 setrgbcolor" << endl;  // anti-alias to white background
-        t << "newpath" << endl;
-        t << "-1 -1 moveto" << endl;
-        t << (x2-x1+2) << " -1 lineto" << endl;
-        t << (x2-x1+2) << " " << (y2-y1+2) << " lineto" << endl;
-        t << "-1 " << (y2-y1+2) << " lineto" <<endl;
-        t << "closepath" << endl;
-        t << "fill" << endl;
-        t << -x1 << " " << -y1 << " translate" << endl;
-        t << "0 0 0 setrgbcolor" << endl;
-        t << "(" << formBase << ".eps) run" << endl;
-        f.close();
       }
-      // scale the image so that it is four times larger than needed.
-      // and the sizes are a multiple of four.
-      double scaleFactor = 16.0/3.0; 
-      int zoomFactor = Config_getInt("FORMULA_FONTSIZE");
-      if (zoomFactor<8 || zoomFactor>50) zoomFactor=10;
-      scaleFactor *= zoomFactor/10.0;
-      int gx = (((int)((x2-x1)*scaleFactor))+3)&~1;
-      int gy = (((int)((y2-y1)*scaleFactor))+3)&~1;
-      // Then we run ghostscript to convert the postscript to a pixmap
-      // The pixmap is a truecolor image, where only black and white are
-      // used.  
-
-      char gsArgs[4096];
-      sprintf(gsArgs,"-q -g%dx%d -r%dx%dx -sDEVICE=ppmraw "
-                    "-sOutputFile=%s.pnm -dNOPAUSE -dBATCH -- %s.ps",
-                    gx,gy,(int)(scaleFactor*72),(int)(scaleFactor*72),
-                    formBase.data(),formBase.data()
-             );
-      portable_sysTimerStart();
-      if (portable_system(portable_ghostScriptCommand(),gsArgs)!=0)
+      // wait for the workers to finish
+      for (i=0;i<(int)workers.count();i++)
       {
-        err("Problem running ghostscript %s %s. Check your installation!\n",portable_ghostScriptCommand(),gsArgs);
-        portable_sysTimerStop();
-        return;
+        workers.at(i)->wait();
       }
-      portable_sysTimerStop();
-      f.setName(formBase+".pnm");
-      uint imageX=0,imageY=0;
-      // we read the generated image again, to obtain the pixel data.
-      if (f.open(IO_ReadOnly))
-      {
-        QTextStream t(&f);
-        QCString s;
-        if (!t.eof())
-          s=t.readLine().utf8();
-        if (s.length()<2 || s.left(2)!="P6")
-          err("ghostscript produced an illegal image format!");
-        else
-        {
-          // assume the size is after the first line that does not start with
-          // # excluding the first line of the file.
-          while (!t.eof() && (s=t.readLine().utf8()) && !s.isEmpty() && s.at(0)=='#') { }
-          sscanf(s,"%d %d",&imageX,&imageY);
-        }
-        if (imageX>0 && imageY>0)
-        {
-          //printf("Converting image...\n");
-          char *data = new char[imageX*imageY*3]; // rgb 8:8:8 format
-          uint i,x,y,ix,iy;
-          f.readBlock(data,imageX*imageY*3);
-          Image srcImage(imageX,imageY),
-                filteredImage(imageX,imageY),
-                dstImage(imageX/4,imageY/4);
-          uchar *ps=srcImage.getData();
-          // convert image to black (1) and white (0) index.
-          for (i=0;i<imageX*imageY;i++) *ps++= (data[i*3]==0 ? 1 : 0);
-          // apply a simple box filter to the image 
-          static int filterMask[]={1,2,1,2,8,2,1,2,1};
-          for (y=0;y<srcImage.getHeight();y++)
-          {
-            for (x=0;x<srcImage.getWidth();x++)
-            {
-              int s=0;
-              for (iy=0;iy<2;iy++)
-              {
-                for (ix=0;ix<2;ix++)
-                {
-                  s+=srcImage.getPixel(x+ix-1,y+iy-1)*filterMask[iy*3+ix];
-                }
-              }
-              filteredImage.setPixel(x,y,s);
-            }
-          }
-          // down-sample the image to 1/16th of the area using 16 gray scale
-          // colors.
-          // TODO: optimize this code.
-          for (y=0;y<dstImage.getHeight();y++)
-          {
-            for (x=0;x<dstImage.getWidth();x++)
-            {
-              int xp=x<<2;
-              int yp=y<<2;
-              int c=filteredImage.getPixel(xp+0,yp+0)+
-                    filteredImage.getPixel(xp+1,yp+0)+
-                    filteredImage.getPixel(xp+2,yp+0)+
-                    filteredImage.getPixel(xp+3,yp+0)+
-                    filteredImage.getPixel(xp+0,yp+1)+
-                    filteredImage.getPixel(xp+1,yp+1)+
-                    filteredImage.getPixel(xp+2,yp+1)+
-                    filteredImage.getPixel(xp+3,yp+1)+
-                    filteredImage.getPixel(xp+0,yp+2)+
-                    filteredImage.getPixel(xp+1,yp+2)+
-                    filteredImage.getPixel(xp+2,yp+2)+
-                    filteredImage.getPixel(xp+3,yp+2)+
-                    filteredImage.getPixel(xp+0,yp+3)+
-                    filteredImage.getPixel(xp+1,yp+3)+
-                    filteredImage.getPixel(xp+2,yp+3)+
-                    filteredImage.getPixel(xp+3,yp+3);
-              // here we scale and clip the color value so the
-              // resulting image has a reasonable contrast
-              dstImage.setPixel(x,y,QMIN(15,(c*15)/(16*10)));
-            }
-          }
-          // save the result as a bitmap
-          QCString resultName;
-          resultName.sprintf("form_%d.png",pageNum);
-          // the option parameter 1 is used here as a temporary hack
-          // to select the right color palette! 
-          dstImage.save(resultName,1);
-          delete[] data;
-        }
-        f.close();
-      } 
-      // remove intermediate image files
-      thisDir.remove(formBase+".eps");
-      thisDir.remove(formBase+".pnm");
-      thisDir.remove(formBase+".ps");
+    }
+    if (workers.count()==0) // no threads to work with
+    {
+      FormulaWorkerThread(&queue,scaleFactor).run();
+    }
+    portable_sysTimerStop();
+    if (queue.failed())
+    {
+      QDir::setCurrent(oldDir);
+      return;
     }
     // remove intermediate files produced by latex
     thisDir.remove("_formulas.dvi");
@@ -310,6 +430,20 @@ void FormulaList::generateBitmaps(const char *path)
     }
     f.close();
   }
+  // remember the settings used for the images. After a latex error the
+  // images may be wrong or missing, so the settings are only recorded for
+  // a clean run; the empty file written otherwise makes the next run 
+  // regenerate all images.
+  f.setName("formula.settings");
+  if (f.open(IO_WriteOnly))
+  {
+    if (!formulaError)
+    {
+      FTextStream t(&f);
+      t << settings << endl;
+    }
+    f.close();
+  }
   // reset the directory to the original location.
   QDir::setCurrent(oldDir);
 }
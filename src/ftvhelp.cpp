@@ -444,16 +444,15 @@ class NavIndexEntryList : public QList<NavIndexEntry>
     }
 };
 
-static QCString pathToNode(FTVNode *leaf,FTVNode *n)
+/*! Returns the path of indices from the root to node \a n, given the 
+ *  path \a parentPath of its parent, so the path of each node is built 
+ *  once while walking the tree.
+ */
+static QCString pathToNode(const QCString &parentPath,FTVNode *n)
 {
-  QCString result;
-  if (n->parent)
-  {
-    result+=pathToNode(leaf,n->parent);
-  }
-  result+=QCString().setNum(n->index);
-  if (leaf!=n) result+=",";
-  return result;
+  QCString index;
+  index.setNum(n->index);
+  return parentPath.isEmpty() ? index : parentPath+","+index;
 }
 
 static bool dupOfParent(const FTVNode *n)
@@ -487,7 +486,8 @@ static QCString convertFileId2Var(const QCString &fileId)
 }
 
 static bool generateJSTree(NavIndexEntryList &navIndex,FTextStream &t, 
-                           const QList<FTVNode> &nl,int level,bool &first)
+                           const QList<FTVNode> &nl,int level,bool &first,
+                           const QCString &parentPath)
 {
   static QCString htmlOutput = Config_getString("HTML_OUTPUT");
   QCString indentStr;
@@ -508,6 +508,7 @@ static bool generateJSTree(NavIndexEntryList &navIndex,FTextStream &t,
     }
     found=TRUE;
 
+    QCString path = pathToNode(parentPath,n);
     if (n->addToNavIndex) // add entry to the navigation index
     {
       if (n->def && n->def->definitionType()==Definition::TypeFile)
@@ -517,16 +518,16 @@ static bool generateJSTree(NavIndexEntryList &navIndex,FTextStream &t,
         doc = fileVisibleInIndex(fd,src);
         if (doc)
         {
-          navIndex.append(new NavIndexEntry(node2URL(n,TRUE,FALSE),pathToNode(n,n)));
+          navIndex.append(new NavIndexEntry(node2URL(n,TRUE,FALSE),path));
         }
         if (src)
         {
-          navIndex.append(new NavIndexEntry(node2URL(n,TRUE,TRUE),pathToNode(n,n)));
+          navIndex.append(new NavIndexEntry(node2URL(n,TRUE,TRUE),path));
         }
       }
       else
       {
-        navIndex.append(new NavIndexEntry(node2URL(n),pathToNode(n,n)));
+        navIndex.append(new NavIndexEntry(node2URL(n),path));
       }
     }
 
@@ -551,7 +552,7 @@ static bool generateJSTree(NavIndexEntryList &navIndex,FTextStream &t,
         {
           FTextStream tt(&f);
           tt << "var " << convertFileId2Var(fileId) << " =" << endl;
-          generateJSTree(navIndex,tt,n->children,1,firstChild);
+          generateJSTree(navIndex,tt,n->children,1,firstChild,path);
           tt << endl << "];"; 
         }
         t << "\"" << fileId << "\" ]";
@@ -566,7 +567,7 @@ static bool generateJSTree(NavIndexEntryList &navIndex,FTextStream &t,
       bool firstChild=TRUE;
       t << indentStr << "  [ ";
       generateJSLink(t,n);
-      bool emptySection = !generateJSTree(navIndex,t,n->children,level+1,firstChild);
+      bool emptySection = !generateJSTree(navIndex,t,n->children,level+1,firstChild,path);
       if (emptySection)
         t << "null ]";
       else
@@ -615,7 +616,7 @@ static void generateJSNavTree(const QList<FTVNode> &nodeList)
     navIndex.append(new NavIndexEntry("pages"+Doxygen::htmlFileExtension,""));
 
     bool first=TRUE;
-    generateJSTree(navIndex,t,nodeList,1,first);
+    generateJSTree(navIndex,t,nodeList,1,first,QCString());
 
     if (first) 
       t << "]" << endl;
@@ -116,24 +116,81 @@ static void endIndexHierarchy(OutputList &ol,int level)
 
 //----------------------------------------------------------------------------
 
+/** Sort key of a member in the member index. The qualified name is only
+ *  computed when the names of two members are equal.
+ */
+struct MemberIndexSortKey
+{
+  MemberIndexSortKey(MemberDef *m) : md(m), name(m->name()), qualifiedNameValid(FALSE) {}
+  const QCString &getQualifiedName()
+  {
+    if (!qualifiedNameValid)
+    {
+      qualifiedName = md->qualifiedName();
+      qualifiedNameValid = TRUE;
+    }
+    return qualifiedName;
+  }
+  MemberDef *md;
+  QCString name;
+  QCString qualifiedName;
+  bool qualifiedNameValid;
+};
+
+static int compareMemberIndexSortKeys(const void *p1,const void *p2)
+{
+  MemberIndexSortKey *k1 = *(MemberIndexSortKey **)p1;
+  MemberIndexSortKey *k2 = *(MemberIndexSortKey **)p2;
+  int result = qstricmp(k1->name,k2->name);
+  if (result==0)
+  {
+    result = qstricmp(k1->getQualifiedName(),k2->getQualifiedName());
+  }
+  return result;
+}
+
 class MemberIndexList : public QList<MemberDef>
 {
   public:
     typedef MemberDef ElementType;
-    MemberIndexList(uint letter) : QList<MemberDef>(), m_letter(letter) {}
+    MemberIndexList(uint letter) : QList<MemberDef>(), m_letter(letter), m_sorted(FALSE) {}
     ~MemberIndexList() {}
-    int compareValues(const MemberDef *md1, const MemberDef *md2) const
+    void append(const MemberDef *md)
     {
-      int result = qstricmp(md1->name(),md2->name());
-      if (result==0)
+      QList<MemberDef>::append(md);
+      m_sorted=FALSE;
+    }
+    /*! Sorts the members on name and then on qualified name. The names
+     *  of each member are obtained only once and an array is sorted 
+     *  instead of the list. The list is only sorted again if members
+     *  were added since the last call.
+     */
+    void sortMembers()
+    {
+      if (m_sorted) return;
+      m_sorted=TRUE;
+      uint n=count(),i=0;
+      if (n<2) return;
+      MemberIndexSortKey **keys = new MemberIndexSortKey*[n];
+      QListIterator<MemberDef> mli(*this);
+      MemberDef *md;
+      for (mli.toFirst();(md=mli.current());++mli)
+      {
+        keys[i++] = new MemberIndexSortKey(md);
+      }
+      qsort(keys,n,sizeof(MemberIndexSortKey*),compareMemberIndexSortKeys);
+      clear();
+      for (i=0;i<n;i++)
       {
-        result = qstricmp(md1->qualifiedName(),md2->qualifiedName());
+        QList<MemberDef>::append(keys[i]->md);
+        delete keys[i];
       }
-      return result;
+      delete[] keys;
     }
     uint letter() const { return m_letter; }
   private:
     uint m_letter;
+    bool m_sorted;
 };
 
 static LetterToIndexMap<MemberIndexList> g_memberIndexLetterUsed[CMHL_Total];
@@ -2185,7 +2242,7 @@ static void writeMemberList(OutputList &ol,bool useSections,int page,
       it.toLast();
     }
     if (ml==0 || ml->count()==0) continue;
-    ml->sort();
+    ml->sortMembers();
     QListIterator<MemberDef> mli(*ml);
     MemberDef *md;
     for (mli.toFirst();(md=mli.current());++mli)
@@ -282,7 +282,7 @@ void ManDocVisitor::visit(DocInclude *inc)
       Doxygen::parserManager->getParser(inc->extension())
                             ->parseCode(m_ci,
                                         inc->context(),
-                                        extractBlock(inc->text(),inc->blockId()),
+                                        inc->text(),
                                         langExt,
                                         inc->isExample(),
                                         inc->exampleFile()
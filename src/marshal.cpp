@@ -1,3 +1,6 @@
+#include <stdlib.h>
+#include <string.h>
+
 #include <qfile.h>
 #include <assert.h>
 
@@ -10,33 +13,93 @@
 #include "groupdef.h"
 #include "example.h"
 #include "arguments.h"
+#include "util.h"
 
 #define HEADER ('D'<<24)+('O'<<16)+('X'<<8)+'!'
 
-void marshalInt(StorageIntf *s,int v)
+RecordBuffer::RecordBuffer() : m_data(0), m_size(0), m_capacity(0), m_pos(0)
+{
+}
+
+RecordBuffer::~RecordBuffer()
+{
+  free(m_data);
+}
+
+int RecordBuffer::write(const char *buf,uint size)
+{
+  if (m_size+size>m_capacity)
+  {
+    m_capacity = QMAX(m_capacity*2,m_size+size);
+    m_capacity = QMAX(m_capacity,1024);
+    m_data = (char *)realloc(m_data,m_capacity);
+  }
+  memcpy(m_data+m_size,buf,size);
+  m_size+=size;
+  return size;
+}
+
+int RecordBuffer::read(char *buf,uint size)
+{
+  if (m_pos+size>m_size) size=m_size-m_pos;
+  memcpy(buf,m_data+m_pos,size);
+  m_pos+=size;
+  return size;
+}
+
+void RecordBuffer::writeRecord(StorageIntf *s)
+{
+  marshalUInt(s,m_size);
+  if (m_size>0) s->write(m_data,m_size);
+}
+
+bool RecordBuffer::readRecord(StorageIntf *s)
 {
-  uchar b[4];
-  b[0]=((uint)v)>>24;
-  b[1]=(((uint)v)>>16)&0xff;
-  b[2]=(((uint)v)>>8)&0xff;
-  b[3]=v&0xff;
-  s->write((const char *)b,4);
+  clear();
+  uint size = unmarshalUInt(s);
+  if (size>m_capacity)
+  {
+    m_capacity = QMAX(size,1024);
+    m_data = (char *)realloc(m_data,m_capacity);
+  }
+  if (size>0 && s->read(m_data,size)!=(int)size) return FALSE;
+  m_size=size;
+  return TRUE;
 }
 
+
 void marshalUInt(StorageIntf *s,uint v)
 {
-  uchar b[4];
-  b[0]=v>>24;
-  b[1]=(v>>16)&0xff;
-  b[2]=(v>>8)&0xff;
-  b[3]=v&0xff;
-  s->write((const char *)b,4);
+  // variable length encoding: 7 bits per byte, the high bit is set
+  // if more bytes follow
+  uchar b[5];
+  int n=0;
+  while (v>=0x80)
+  {
+    b[n++]=(uchar)(v|0x80);
+    v>>=7;
+  }
+  b[n++]=(uchar)v;
+  s->write((const char *)b,n);
+}
+
+void marshalInt(StorageIntf *s,int v)
+{
+  // zig-zag encode the value, so small negative numbers stay small
+  marshalUInt(s,v<0 ? ~(((uint)v)<<1) : ((uint)v)<<1);
 }
 
 void marshalUInt64(StorageIntf *s,uint64 v)
 {
-  marshalUInt(s, uint(v>>32));
-  marshalUInt(s, uint(v&0xFFFFFFFF));
+  uchar b[10];
+  int n=0;
+  while (v>=0x80)
+  {
+    b[n++]=(uchar)(v|0x80);
+    v>>=7;
+  }
+  b[n++]=(uchar)v;
+  s->write((const char *)b,n);
 }
 
 void marshalBool(StorageIntf *s,bool b)
@@ -344,9 +407,27 @@ void marshalMemberLists(StorageIntf *s,SDict<MemberList> *mls)
   }
 }
 
+/*! Writes file name \a name, which is often equal to the file name \a ref
+ *  written before it, so it is stored as a single byte in that case.
+ */
+static void marshalFileName(StorageIntf *s,const QCString &name,const QCString &ref)
+{
+  if (name==ref)
+  {
+    marshalUInt(s,0);
+  }
+  else
+  {
+    uint l=name.length();
+    marshalUInt(s,l+1);
+    if (l>0) s->write(name.data(),l);
+  }
+}
+
 void marshalEntry(StorageIntf *s,Entry *e)
 {
   marshalUInt(s,HEADER);
+  marshalQCString(s,e->fileName);
   marshalQCString(s,e->name);
   marshalQCString(s,e->type);
   marshalInt(s,e->section);
@@ -371,13 +452,13 @@ void marshalEntry(StorageIntf *s,Entry *e)
   marshalQCString(s,e->includeName);
   marshalQCString(s,e->doc);
   marshalInt(s,e->docLine);
-  marshalQCString(s,e->docFile);
+  marshalFileName(s,e->docFile,e->fileName);
   marshalQCString(s,e->brief);
   marshalInt(s,e->briefLine);
-  marshalQCString(s,e->briefFile);
+  marshalFileName(s,e->briefFile,e->fileName);
   marshalQCString(s,e->inbodyDocs);
   marshalInt(s,e->inbodyLine);
-  marshalQCString(s,e->inbodyFile);
+  marshalFileName(s,e->inbodyFile,e->fileName);
   marshalQCString(s,e->relates);
   marshalInt(s,e->relatesType);
   marshalQCString(s,e->read);
@@ -391,7 +472,6 @@ void marshalEntry(StorageIntf *s,Entry *e)
   marshalBaseInfoList(s,e->extends);
   marshalGroupingList(s,e->groups);
   marshalSectionInfoList(s,e->anchors);
-  marshalQCString(s,e->fileName);
   marshalInt(s,e->startLine);
   marshalItemInfoList(s,e->sli);
   marshalInt(s,(int)e->lang);
@@ -415,28 +495,40 @@ void marshalEntryTree(StorageIntf *s,Entry *e)
 
 //------------------------------------------------------------------
 
-int unmarshalInt(StorageIntf *s)
+uint unmarshalUInt(StorageIntf *s)
 {
-  uchar b[4];
-  s->read((char *)b,4);
-  int result=(int)((((uint)b[0])<<24)+((uint)b[1]<<16)+((uint)b[2]<<8)+(uint)b[3]);
-  //printf("unmarshalInt: %x %x %x %x: %x offset=%llx\n",b[0],b[1],b[2],b[3],result,f.pos());
+  uint result=0;
+  int shift=0;
+  uchar b;
+  do
+  {
+    if (s->read((char *)&b,1)!=1) break;
+    result|=((uint)(b&0x7f))<<shift;
+    shift+=7;
+  }
+  while ((b&0x80) && shift<35);
+  //printf("unmarshalUInt: %x offset=%llx\n",result,f.pos());
   return result;
 }
 
-uint unmarshalUInt(StorageIntf *s)
+int unmarshalInt(StorageIntf *s)
 {
-  uchar b[4];
-  s->read((char *)b,4);
-  uint result=(((uint)b[0])<<24)+((uint)b[1]<<16)+((uint)b[2]<<8)+(uint)b[3];
-  //printf("unmarshalUInt: %x %x %x %x: %x offset=%llx\n",b[0],b[1],b[2],b[3],result,f.pos());
-  return result;
+  uint v = unmarshalUInt(s);
+  return (v&1) ? (int)~(v>>1) : (int)(v>>1);
 }
 
 uint64 unmarshalUInt64(StorageIntf *s)
 {
-  uint64 result=uint64(unmarshalUInt(s))<<32;
-  result|=unmarshalUInt(s);
+  uint64 result=0;
+  int shift=0;
+  uchar b;
+  do
+  {
+    if (s->read((char *)&b,1)!=1) break;
+    result|=((uint64)(b&0x7f))<<shift;
+    shift+=7;
+  }
+  while ((b&0x80) && shift<70);
   return result;
 }
 
@@ -546,7 +638,7 @@ QList<SectionInfo> *unmarshalSectionInfoList(StorageIntf *s)
     QCString title = unmarshalQCString(s);
     QCString ref   = unmarshalQCString(s);
     SectionInfo::SectionType type = (SectionInfo::SectionType)unmarshalInt(s);
-    QCString fileName = unmarshalQCString(s);
+    QCString fileName = internString(unmarshalQCString(s));
     int lineNr = unmarshalInt(s);
     int level = unmarshalInt(s);
     result->append(new SectionInfo(fileName,lineNr,label,title,type,level,ref));
@@ -724,11 +816,27 @@ SDict<MemberList> *unmarshalMemberLists(StorageIntf *s)
   return result;
 }
 
+/*! Reads a file name written by marshalFileName() */
+static QCString unmarshalFileName(StorageIntf *s,const QCString &ref)
+{
+  uint len = unmarshalUInt(s);
+  if (len==0) return ref;
+  len--;
+  QCString result(len+1);
+  result.at(len)='\0';
+  if (len>0)
+  {
+    s->read(result.rawData(),len);
+  }
+  return internString(result);
+}
+
 Entry * unmarshalEntry(StorageIntf *s)
 {
   Entry *e = new Entry;
   uint header=unmarshalUInt(s);
   ASSERT(header==HEADER);
+  e->fileName         = internString(unmarshalQCString(s));
   e->name             = unmarshalQCString(s);
   e->type             = unmarshalQCString(s);
   e->section          = unmarshalInt(s);
@@ -750,17 +858,17 @@ Entry * unmarshalEntry(StorageIntf *s)
   e->tArgLists        = unmarshalArgumentLists(s);
   e->program          = unmarshalQGString(s);
   e->initializer      = unmarshalQGString(s);
-  e->includeFile      = unmarshalQCString(s);
+  e->includeFile      = internString(unmarshalQCString(s));
   e->includeName      = unmarshalQCString(s);
   e->doc              = unmarshalQCString(s);
   e->docLine          = unmarshalInt(s);
-  e->docFile          = unmarshalQCString(s);
+  e->docFile          = unmarshalFileName(s,e->fileName);
   e->brief            = unmarshalQCString(s);
   e->briefLine        = unmarshalInt(s);
-  e->briefFile        = unmarshalQCString(s);
+  e->briefFile        = unmarshalFileName(s,e->fileName);
   e->inbodyDocs       = unmarshalQCString(s);
   e->inbodyLine       = unmarshalInt(s);
-  e->inbodyFile       = unmarshalQCString(s);
+  e->inbodyFile       = unmarshalFileName(s,e->fileName);
   e->relates          = unmarshalQCString(s);
   e->relatesType      = (RelatesType)unmarshalInt(s);
   e->read             = unmarshalQCString(s);
@@ -777,7 +885,6 @@ Entry * unmarshalEntry(StorageIntf *s)
   e->groups           = unmarshalGroupingList(s);
   delete e->anchors;
   e->anchors          = unmarshalSectionInfoList(s);
-  e->fileName         = unmarshalQCString(s);
   e->startLine        = unmarshalInt(s);
   e->sli              = unmarshalItemInfoList(s);
   e->lang             = (SrcLangExt)unmarshalInt(s);
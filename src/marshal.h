@@ -40,6 +40,33 @@ class Entry;
 
 #define NULL_LIST 0xffffffff
 
+/** @brief Memory buffer used to marshal a complete record.
+ *
+ *  The fields of a record are collected with write() and then
+ *  passed to the underlying storage in one go with writeRecord().
+ *  readRecord() reads such a record back in one go, after which the
+ *  fields can be unmarshaled from memory with read().
+ */
+class RecordBuffer : public StorageIntf
+{
+  public:
+    RecordBuffer();
+   ~RecordBuffer();
+    int read(char *buf,uint size);
+    int write(const char *buf,uint size);
+    /*! Empties the buffer */
+    void clear() { m_size=0; m_pos=0; }
+    /*! Writes the buffered record to \a s, preceded by its size. */
+    void writeRecord(StorageIntf *s);
+    /*! Replaces the buffer contents by a record read from \a s. */
+    bool readRecord(StorageIntf *s);
+  private:
+    char *m_data;
+    uint  m_size;
+    uint  m_capacity;
+    uint  m_pos;
+};
+
 //----- marshaling function: datatype -> byte stream --------------------
 
 void marshalInt(StorageIntf *s,int v);
@@ -636,9 +636,9 @@ void MemberDefImpl::init(Definition *def,
   //  type.stripPrefix("struct ");
   //  type.stripPrefix("class " );
   //  type.stripPrefix("union " );
-  type=removeRedundantWhiteSpace(type);
+  type=internString(removeRedundantWhiteSpace(type));
   args=a;
-  args=removeRedundantWhiteSpace(args);
+  args=internString(removeRedundantWhiteSpace(args));
   if (type.isEmpty()) decl=def->name()+args; else decl=type+" "+def->name()+args;
 
   memberGroup=0;
@@ -3884,7 +3884,7 @@ void MemberDef::setTypeConstraints(ArgumentList *al)
 
 void MemberDef::setType(const char *t)
 {
-  m_impl->type = t;
+  m_impl->type = internString(t);
 }
 
 void MemberDef::setAccessorType(ClassDef *cd,const char *t)
@@ -4685,7 +4685,7 @@ void MemberDef::setInheritsDocsFrom(MemberDef *md)
 
 void MemberDef::setArgsString(const char *as)
 {
-  m_impl->args = as;
+  m_impl->args = internString(as);
 }
 
 void MemberDef::setRelatedAlso(ClassDef *cd)
@@ -350,7 +350,7 @@ void MemberGroup::marshal(StorageIntf *s)
   marshalInt(s,m_numDocMembers);
   marshalObjPointer(s,m_parent);
   marshalQCString(s,m_docFile);
-  marshalItemInfoList (Doxygen::symbolStorage,m_xrefListItems);
+  marshalItemInfoList (s,m_xrefListItems);
 }
 
 void MemberGroup::unmarshal(StorageIntf *s)
@@ -367,7 +367,7 @@ void MemberGroup::unmarshal(StorageIntf *s)
   m_numDocMembers = unmarshalInt(s);
   m_parent        = (Definition *)unmarshalObjPointer(s);
   m_docFile       = unmarshalQCString(s);
-  m_xrefListItems = unmarshalItemInfoList (Doxygen::symbolStorage);
+  m_xrefListItems = unmarshalItemInfoList (s);
 }
 
 void MemberGroup::setRefItems(const QList<ListItemInfo> *sli)
@@ -96,6 +96,25 @@ void writeMscGraphFromFile(const char *inFile,const char *outDir,
   absOutFile+=portable_pathSeparator();
   absOutFile+=outFile;
 
+  // skip running msc if the input and the requested format are unchanged
+  // since the previous run and the image is still present
+  bool pdfNeeded = format==MSC_EPS && Config_getBool("USE_PDFLATEX");
+  {
+    QCString sigStr = computeFileMd5(inFile,
+                          QCString().setNum((int)format)+(pdfNeeded?"pdf":""));
+    QCString imgExt;
+    if (format==MSC_BITMAP) imgExt=".png";
+    else if (format==MSC_EPS) imgExt=".eps";
+    else if (format==MSC_SVG) imgExt=".svg";
+    if (!sigStr.isEmpty() &&
+        !checkAndUpdateMd5Signature(absOutFile,sigStr) &&
+        checkDeliverables(absOutFile+imgExt,
+                          pdfNeeded ? absOutFile+".pdf" : QCString()))
+    {
+      return;
+    }
+  }
+
   // chdir to the output dir, so dot can find the font file.
   QCString oldDir = QDir::currentDirPath().utf8();
   // go to the html output directory (i.e. path)
@@ -136,7 +155,7 @@ void writeMscGraphFromFile(const char *inFile,const char *outDir,
     goto error;
   }
   portable_sysTimerStop();
-  if ( (format==MSC_EPS) && (Config_getBool("USE_PDFLATEX")) )
+  if (pdfNeeded)
   {
     QCString epstopdfArgs(maxCmdLine);
     epstopdfArgs.sprintf("\"%s.eps\" --outfile=\"%s.pdf\"",
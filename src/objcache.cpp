@@ -26,9 +26,9 @@
 //----------------------------------------------------------------------
 
 ObjCache::ObjCache(unsigned int logSize) 
-  : m_head(-1), m_tail(-1), //m_numEntries(0), 
-    m_size(1<<logSize), m_count(0), m_freeHashNodes(0), m_freeCacheNodes(0), 
-    m_lastHandle(-1)
+  : m_hand(0), m_size(1<<logSize), m_count(0), 
+    m_freeHashNodes(0), m_freeCacheNodes(0),
+    m_misses(0), m_hits(0), m_evictions(0)
 {
   int i;
   m_cache = new CacheNode[m_size];
@@ -39,8 +39,6 @@ ObjCache::ObjCache(unsigned int logSize)
     m_hash[i].nextHash = i+1;
     m_cache[i].next    = i+1;
   }
-  m_misses = 0;
-  m_hits   = 0;
 }
 
 ObjCache::~ObjCache()
@@ -49,57 +47,60 @@ ObjCache::~ObjCache()
   delete[] m_hash;
 }
 
+int ObjCache::nextVictim()
+{
+  // advance the clock hand until an entry is found that was not used
+  // since the hand last passed it. This ends after at most one full round.
+  while (m_cache[m_hand].referenced)
+  {
+    m_cache[m_hand].referenced = FALSE;
+    m_hand = (m_hand+1)&(m_size-1);
+  }
+  int index = m_hand;
+  m_hand = (m_hand+1)&(m_size-1);
+  return index;
+}
+
 int ObjCache::add(void *obj,void **victim)
 {
   *victim=0;
 
   HashNode *hnode = hashFind(obj);
   //printf("hnode=%p\n",hnode);
-  if (hnode) // move object to the front of the LRU list, since it is used
-    // most recently
+  if (hnode) // already in the cache, mark it as used
   {
-    //printf("moveToFront=%d\n",hnode->index);
-    moveToFront(hnode->index);
+    m_cache[hnode->index].referenced = TRUE;
     m_hits++;
+    return hnode->index;
   }
-  else // object not in the cache.
-  {
-    void *lruObj=0;
-    if (m_freeCacheNodes!=-1) // cache not full -> add element to the cache
-    {
-      // remove element from free list
-      int index = m_freeCacheNodes;
-      m_freeCacheNodes = m_cache[index].next;
 
-      // add to head of the list
-      if (m_tail==-1)
-      {
-        m_tail = index;
-      }
-      m_cache[index].prev = -1;
-      m_cache[index].next = m_head;
-      if (m_head!=-1)
-      {
-        m_cache[m_head].prev = index;
-      }
-      m_head = index;
-      m_count++;
-    }
-    else // cache full -> replace element in the cache
-    {
-      //printf("Cache full!\n");
-      lruObj = m_cache[m_tail].obj;
-      hashRemove(lruObj);
-      moveToFront(m_tail); // m_tail indexes the emptied element, which becomes m_head
-    }
-    //printf("numEntries=%d size=%d\n",m_numEntries,m_size);
-    m_cache[m_head].obj = obj;
-    hnode = hashInsert(obj);
-    hnode->index = m_head;
-    *victim = lruObj;
-    m_misses++;
+  // object not in the cache.
+  int index;
+  void *lruObj=0;
+  if (m_freeCacheNodes!=-1) // cache not full -> add element to the cache
+  {
+    // remove element from free list
+    index = m_freeCacheNodes;
+    m_freeCacheNodes = m_cache[index].next;
+    m_cache[index].next = -1;
+    m_count++;
   }
-  return m_head;
+  else // cache full -> replace element in the cache
+  {
+    //printf("Cache full!\n");
+    index = nextVictim();
+    lruObj = m_cache[index].obj;
+    hashRemove(lruObj);
+    m_evictions++;
+  }
+  //printf("count=%d size=%d\n",m_count,m_size);
+  m_cache[index].obj = obj;
+  m_cache[index].referenced = TRUE;
+  hnode = hashInsert(obj);
+  hnode->index = index;
+  *victim = lruObj;
+  m_misses++;
+  return index;
 }
 
 void ObjCache::del(int index)
@@ -107,14 +108,8 @@ void ObjCache::del(int index)
   assert(index!=-1);
   assert(m_cache[index].obj!=0);
   hashRemove(m_cache[index].obj);
-  moveToFront(index);
-  m_head = m_cache[index].next;
-  if (m_head==-1) 
-    m_tail=-1;
-  else 
-    m_cache[m_head].prev=-1;
   m_cache[index].obj=0;
-  m_cache[index].prev=-1;
+  m_cache[index].referenced=FALSE;
   m_cache[index].next = m_freeCacheNodes;
   m_freeCacheNodes = index;
   m_count--;
@@ -124,52 +119,25 @@ void ObjCache::del(int index)
 #define cache_debug_printf printf
 void ObjCache::printLRU()
 {
-  cache_debug_printf("MRU->LRU: ");
-  int index = m_head;
-  while (index!=-1)
+  cache_debug_printf("hand=%d: ",m_hand);
+  int index;
+  for (index=0;index<m_size;index++)
   {
-    cache_debug_printf("%d=%p ",index,m_cache[index].obj);
-    index = m_cache[index].next;
-  }
-  cache_debug_printf("\n");
-
-  cache_debug_printf("LRU->MRU: ");
-  index = m_tail;
-  while (index!=-1)
-  {
-    cache_debug_printf("%d=%p ",index,m_cache[index].obj);
-    index = m_cache[index].prev;
+    if (m_cache[index].obj)
+    {
+      cache_debug_printf("%d=%p%s ",index,m_cache[index].obj,
+                         m_cache[index].referenced ? "*" : "");
+    }
   }
   cache_debug_printf("\n");
 }
 #endif
 
-#ifdef CACHE_STATS
-#define cache_stats_printf printf
 void ObjCache::printStats()
 {
-  cache_stats_printf("ObjCache: hits=%d misses=%d hit ratio=%f\n",m_hits,m_misses,m_hits*100.0/(m_hits+m_misses));
-}
-#endif
-
-void ObjCache::moveToFront(int index)
-{
-  int prev,next;
-  if (m_head!=index)
-  {
-    next = m_cache[index].next;
-    prev = m_cache[index].prev;
-
-    // de-chain node at index
-    m_cache[prev].next = next;
-    if (next!=-1) m_cache[next].prev = prev; else m_tail = prev;
-
-    // add to head
-    m_cache[index].prev  = -1;
-    m_cache[index].next  = m_head;
-    m_cache[m_head].prev = index;
-    m_head = index;
-  }
+  int total = m_hits+m_misses;
+  printf("ObjCache: hits=%d misses=%d evictions=%d hit ratio=%f\n",
+         m_hits,m_misses,m_evictions,total>0 ? m_hits*100.0/total : 0.0);
 }
 
 unsigned int ObjCache::hash(void *addr)
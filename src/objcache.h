@@ -20,25 +20,35 @@
 
 //#define CACHE_TEST
 //#define CACHE_DEBUG
-#define CACHE_STATS
 
 /** @brief Cache for objects.
  *
  *  This cache is used to decide which objects should remain in
- *  memory. It uses a least recently used policy (LRU) to decide
- *  which object should make room for a new object when the cache
- *  is full. An object should be added using add(), and then use()
+ *  memory. It approximates a least recently used policy using the
+ *  CLOCK algorithm: each use of an object only sets its reference bit,
+ *  and when the cache is full a clock hand sweeps over the entries,
+ *  clearing the reference bits, until it finds an entry that was not
+ *  used since the previous sweep. That entry makes room for the new object.
+ *  An object should be added using add(), and then use()
  *  should be called when the object is used.
+ *
+ *  The cache is not thread safe: use() updates the hit counter and
+ *  the reference bit without synchronization, so all calls must be
+ *  made from one thread or be serialized by the caller.
+ *
+ *  @note Nothing in doxygen currently creates an ObjCache, so there 
+ *  are no run-time statistics to report; printStats() is only used by 
+ *  the CACHE_TEST driver in objcache.cpp.
  */
 class ObjCache
 {
   private:
     struct CacheNode
     {
-      CacheNode() : next(-1), prev(-1), obj(0) {}
-      int next;
-      int prev;
+      CacheNode() : next(-1), obj(0), referenced(FALSE) {}
+      int next;        // next free node
       void *obj;
+      bool referenced; // used since the clock hand last passed
     };
     struct HashNode
     {
@@ -65,16 +75,14 @@ class ObjCache
      */
     int add(void *obj,void **victim);
 
-    /*! Indicates that this object is used. This will move the object
-     *  to the front of the internal LRU list to make sure it is removed last.
+    /*! Indicates that this object is used. This marks the object as
+     *  recently used, so the next sweep of the clock hand will skip it.
      *  The parameter \a handle is returned when called add().
      */
     void use(int handle)
     {
-      if (handle==m_lastHandle) return;
-      m_lastHandle = handle;
+      m_cache[handle].referenced = TRUE;
       m_hits++;
-      moveToFront(handle);
     }
 
     /*! Removes the item identified by \a handle from the cache.
@@ -82,7 +90,7 @@ class ObjCache
      */
     void del(int handle);
 
-    /*! Debug function. Prints the LRU list */
+    /*! Debug function. Prints the contents of the cache */
     void printLRU();
     /*! Print miss/hits statistics */
     void printStats();
@@ -101,10 +109,13 @@ class ObjCache
     { 
       return m_misses; 
     }
-
+    int evictions() const
+    {
+      return m_evictions;
+    }
 
   private:
-    void moveToFront(int index);
+    int nextVictim();
     unsigned int hash(void *addr);
     HashNode *hashFind(void *obj);
     HashNode *hashInsert(void *obj);
@@ -112,15 +123,14 @@ class ObjCache
 
     CacheNode *m_cache;
     HashNode  *m_hash;
-    int        m_head;
-    int        m_tail;
+    int        m_hand;
     int        m_size;
     int        m_count;
     int        m_freeHashNodes;
     int        m_freeCacheNodes;
-    int        m_lastHandle;
     int        m_misses;
     int        m_hits;
+    int        m_evictions;
 };
 
 #endif // OBJCACHE_H
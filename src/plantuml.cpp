@@ -17,6 +17,7 @@
 #include "portable.h"
 #include "config.h"
 #include "message.h"
+#include "util.h"
 
 #include <qdir.h>
 
@@ -51,7 +52,123 @@ QCString writePlantUMLSource(const QCString &outDir,const QCString &fileName,con
   return baseName;
 }
 
+static const char *plantumlExtension(PlantUMLOutputFormat format)
+{
+  switch (format)
+  {
+    case PUML_BITMAP: return ".png";
+    case PUML_EPS:    return ".eps";
+    case PUML_SVG:    return ".svg";
+  }
+  return "";
+}
+
 void generatePlantUMLOutput(const char *baseName,const char *outDir,PlantUMLOutputFormat format)
+{
+  PlantumlManager::instance()->insert(baseName,outDir,format);
+}
+
+//--------------------------------------------------------------------
+
+/** The PlantUML files that are converted with the same output directory
+ *  and image format.
+ */
+struct PlantumlGroup
+{
+  PlantumlGroup(const QCString &dir,PlantUMLOutputFormat fmt)
+    : outDir(dir), format(fmt), files(17) {}
+  QCString outDir;
+  PlantUMLOutputFormat format;
+  QStrList baseNames;
+  QDict<void> files; // to filter out duplicates
+};
+
+PlantumlManager *PlantumlManager::m_theInstance = 0;
+
+PlantumlManager *PlantumlManager::instance()
+{
+  if (!m_theInstance)
+  {
+    m_theInstance = new PlantumlManager;
+  }
+  return m_theInstance;
+}
+
+PlantumlManager::PlantumlManager() : m_groups(17)
+{
+  m_groups.setAutoDelete(TRUE);
+}
+
+void PlantumlManager::insert(const QCString &baseName,const QCString &outDir,
+                             PlantUMLOutputFormat format)
+{
+  bool pdfNeeded = format==PUML_EPS && Config_getBool("USE_PDFLATEX");
+  // the image is written to outDir using the name of the .pu file
+  QCString imgBaseName = baseName;
+  int i=QMAX(imgBaseName.findRev('/'),imgBaseName.findRev('\\'));
+  if (i!=-1) imgBaseName = imgBaseName.mid(i+1);
+  imgBaseName.prepend(outDir+"/");
+  QCString sigStr = computeFileMd5(baseName+".pu",
+                       QCString().setNum((int)format)+(pdfNeeded?"pdf":""));
+  if (!sigStr.isEmpty() &&
+      !checkAndUpdateMd5Signature(imgBaseName,sigStr) &&
+      checkDeliverables(imgBaseName+plantumlExtension(format),
+                        pdfNeeded ? imgBaseName+".pdf" : QCString()))
+  {
+    // image is up to date
+    if (Config_getBool("DOT_CLEANUP"))
+    {
+      QFile(baseName+".pu").remove();
+    }
+    return;
+  }
+
+  QCString key = outDir+":"+QCString().setNum((int)format);
+  PlantumlGroup *group = m_groups.find(key);
+  if (group==0)
+  {
+    group = new PlantumlGroup(outDir,format);
+    m_groups.append(key,group);
+  }
+  if (group->files.find(baseName)==0)
+  {
+    group->files.insert(baseName,(void*)0x8);
+    group->baseNames.append(baseName);
+  }
+}
+
+void PlantumlManager::run()
+{
+  // keep the command lines within the limits of the shell
+  const uint maxArgsLen = 30000;
+  SDict<PlantumlGroup>::Iterator gli(m_groups);
+  PlantumlGroup *group;
+  for (;(group=gli.current());++gli)
+  {
+    QStrList files;
+    uint argsLen = 0;
+    const char *baseName;
+    for (baseName=group->baseNames.first();baseName;baseName=group->baseNames.next())
+    {
+      uint len = qstrlen(baseName)+6;
+      if (!files.isEmpty() && argsLen+len>maxArgsLen)
+      {
+        runGroup(group,files);
+        files.clear();
+        argsLen=0;
+      }
+      files.append(baseName);
+      argsLen+=len;
+    }
+    if (!files.isEmpty())
+    {
+      runGroup(group,files);
+    }
+  }
+  m_groups.clear();
+}
+
+void PlantumlManager::runGroup(PlantumlGroup *group,const QStrList &files)
 {
   static QCString plantumlJarPath = Config_getString("PLANTUML_JAR_PATH");
 
@@ -75,31 +192,32 @@ void generatePlantUMLOutput(const char *baseName,const char *outDir,PlantUMLOutp
   if (pumlIncludePathList.first()) pumlArgs += "\" ";
   pumlArgs += "-Djava.awt.headless=true -jar \""+plantumlJarPath+"plantuml.jar\" ";
   pumlArgs+="-o \"";
-  pumlArgs+=outDir;
+  pumlArgs+=group->outDir;
   pumlArgs+="\" ";
-  QCString extension;
-  switch (format)
+  switch (group->format)
   {
     case PUML_BITMAP:
       pumlArgs+="-tpng";
-      extension=".png";
       break;
     case PUML_EPS:
       pumlArgs+="-teps";
-      extension=".eps";
       break;
     case PUML_SVG:
       pumlArgs+="-tsvg";
-      extension=".svg";
       break;
   }
-  pumlArgs+=" \"";
-  pumlArgs+=baseName;
-  pumlArgs+=".pu\" ";
-  pumlArgs+="-charset " + Config_getString("INPUT_ENCODING") + " ";
+  pumlArgs+=" -charset " + Config_getString("INPUT_ENCODING");
+  QStrListIterator it(files);
+  const char *baseName;
+  for (;(baseName=it.current());++it)
+  {
+    pumlArgs+=" \"";
+    pumlArgs+=baseName;
+    pumlArgs+=".pu\"";
+  }
   int exitCode;
-  //printf("*** running: %s %s outDir:%s %s\n",pumlExe.data(),pumlArgs.data(),outDir,outFile);
-  msg("Running PlantUML on generated file %s.pu\n",baseName);
+  //printf("*** running: %s %s\n",pumlExe.data(),pumlArgs.data());
+  msg("Running PlantUML on %d generated file(s) for %s\n",files.count(),group->outDir.data());
   portable_sysTimerStart();
   if ((exitCode=portable_system(pumlExe,pumlArgs,FALSE))!=0)
   {
@@ -108,19 +226,24 @@ void generatePlantUMLOutput(const char *baseName,const char *outDir,PlantUMLOutp
   }
   else if (Config_getBool("DOT_CLEANUP"))
   {
-    QFile(QCString(baseName)+".pu").remove();
+    for (it.toFirst();(baseName=it.current());++it)
+    {
+      QFile(QCString(baseName)+".pu").remove();
+    }
   }
   portable_sysTimerStop();
-  if ( (format==PUML_EPS) && (Config_getBool("USE_PDFLATEX")) )
+  if ( (group->format==PUML_EPS) && (Config_getBool("USE_PDFLATEX")) )
   {
-    QCString epstopdfArgs(maxCmdLine);
-    epstopdfArgs.sprintf("\"%s.eps\" --outfile=\"%s.pdf\"",baseName,baseName);
-    portable_sysTimerStart();
-    if ((exitCode=portable_system("epstopdf",epstopdfArgs))!=0)
+    for (it.toFirst();(baseName=it.current());++it)
     {
-      err("Problems running epstopdf. Check your TeX installation! Exit code: %d\n",exitCode);
+      QCString epstopdfArgs(maxCmdLine);
+      epstopdfArgs.sprintf("\"%s.eps\" --outfile=\"%s.pdf\"",baseName,baseName);
+      portable_sysTimerStart();
+      if ((exitCode=portable_system("epstopdf",epstopdfArgs))!=0)
+      {
+        err("Problems running epstopdf. Check your TeX installation! Exit code: %d\n",exitCode);
+      }
+      portable_sysTimerStop();
     }
-    portable_sysTimerStop();
   }
 }
-
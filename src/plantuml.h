@@ -16,7 +16,11 @@
 #ifndef PLANTUML_H
 #define PLANTUML_H
 
-class QCString;
+#include <qcstring.h>
+#include <qstrlist.h>
+#include "sortdict.h"
+
+struct PlantumlGroup;
 
 /** Plant UML output image formats */
 enum PlantUMLOutputFormat { PUML_BITMAP, PUML_EPS, PUML_SVG };
@@ -30,11 +34,32 @@ enum PlantUMLOutputFormat { PUML_BITMAP, PUML_EPS, PUML_SVG };
 QCString writePlantUMLSource(const QCString &outDir,const QCString &fileName,const QCString &content);
 
 /** Convert a PlantUML file to an image.
+ *  The conversion is deferred until PlantumlManager::run() is called and
+ *  is skipped if the file and the image are unchanged since the previous run.
  *  @param[in] baseName the name of the generated file (as returned by writePlantUMLSource())
  *  @param[in] outDir   the directory to write the resulting image into.
  *  @param[in] format   the image format to generate.
  */
 void generatePlantUMLOutput(const char *baseName,const char *outDir,PlantUMLOutputFormat format);
 
+/** Singleton that collects the PlantUML files that need to be converted
+ *  and converts them with one java invocation per output directory and
+ *  image format.
+ */
+class PlantumlManager
+{
+  public:
+    static PlantumlManager *instance();
+    void insert(const QCString &baseName,const QCString &outDir,
+                PlantUMLOutputFormat format);
+    void run();
+
+  private:
+    PlantumlManager();
+    void runGroup(PlantumlGroup *group,const QStrList &files);
+    static PlantumlManager *m_theInstance;
+    SDict<PlantumlGroup> m_groups;
+};
+
 #endif
 
@@ -412,7 +412,7 @@ void RTFDocVisitor::visit(DocInclude *inc)
       Doxygen::parserManager->getParser(inc->extension())
                             ->parseCode(m_ci,
                                         inc->context(),
-                                        extractBlock(inc->text(),inc->blockId()),
+                                        inc->text(),
                                         langExt,
                                         inc->isExample(),
                                         inc->exampleFile()
@@ -18,6 +18,7 @@
  */
 
 #include <stdlib.h>
+#include <errno.h>
 
 #include <qdir.h>
 #include <qregexp.h>
@@ -2280,51 +2281,68 @@ bool isLeadBytes(int c)
 }
 
 
-// note: function is not reentrant!
-static void encodeForOutput(FTextStream &t,const char *s)
+/** Checks the integrity of the RTF output by counting brackets while 
+ *  the output is written.
+ */
+class RTFBraceChecker
 {
-  if (s==0) return;
-  QCString encoding;
-  bool converted=FALSE;
-  int l = qstrlen(s);
-  static QByteArray enc;
-  if (l*4>(int)enc.size()) enc.resize(l*4); // worst case
-  encoding.sprintf("CP%s",theTranslator->trRTFansicp().data());
-  if (!encoding.isEmpty())
-  {
-    // convert from UTF-8 back to the output encoding
-    void *cd = portable_iconv_open(encoding,"UTF-8");
-    if (cd!=(void *)(-1))
+  public:
+    RTFBraceChecker() : m_count(0), m_line(1), m_errorLine(0), m_escape(FALSE) {}
+    void check(char c)
     {
-      size_t iLeft=l;
-      size_t oLeft=enc.size();
-      char *inputPtr = (char*)s;
-      char *outputPtr = enc.data();
-      if (!portable_iconv(cd, &inputPtr, &iLeft, &outputPtr, &oLeft))
+      if (m_escape) // escaped char
       {
-        enc.resize(enc.size()-(unsigned int)oLeft);
-        converted=TRUE;
+        m_escape=FALSE;
+      }
+      else if (c=='\\') // escape char
+      {
+        m_escape=TRUE;
+      }
+      else if (c=='{') // open bracket
+      {
+        m_count++;
+      }
+      else if (c=='}') // close bracket
+      {
+        m_count--;
+        if (m_count<0 && m_errorLine==0) m_errorLine=m_line;
+      }
+      else if (c=='\n') // newline
+      {
+        m_line++;
       }
-      portable_iconv_close(cd);
     }
-  }
-  if (!converted) // if we did not convert anything, copy as is.
-  {
-    memcpy(enc.data(),s,l);
-    enc.resize(l);
-  }
-  uint i;
-  bool multiByte = FALSE;
-
-  for (i=0;i<enc.size();i++)
+    void check(const char *s,int len)
+    {
+      int i;
+      for (i=0;i<len;i++) check(s[i]);
+    }
+    //! returns TRUE if the brackets of all output checked so far match.
+    bool isBalanced() const { return m_errorLine==0 && m_count==0; }
+    //! returns the line at which the mismatch was detected.
+    int errorLine() const { return m_errorLine!=0 ? m_errorLine : m_line; }
+  private:
+    int m_count;
+    int m_line;
+    int m_errorLine;
+    bool m_escape;
+};
+
+/** Writes \a l bytes of \a s to \a t, escaping all non-ASCII bytes. */
+static void writeEscaped(FTextStream &t,RTFBraceChecker &checker,
+                         const char *s,int l,bool &multiByte)
+{
+  int i;
+  for (i=0;i<l;i++)
   {
-    uchar c = (uchar)enc.at(i);
+    uchar c = (uchar)s[i];
 
     if (c>=0x80 || multiByte)
     {
       char esc[10];
-      sprintf(esc,"\\'%X",c);        // escape sequence for SBCS and DBCS(1st&2nd bytes).
+      int escLen = sprintf(esc,"\\'%X",c); // escape sequence for SBCS and DBCS(1st&2nd bytes).
       t << esc;
+      checker.check(esc,escLen);
 
       if (!multiByte)
       {
@@ -2338,15 +2356,83 @@ static void encodeForOutput(FTextStream &t,const char *s)
     else
     {
       t << (char)c;
+      checker.check((char)c);
     }
   }
 }
 
+/** Writes the UTF-8 text \a s of length \a l to \a t in the code page of
+ *  the RTF output. The text is converted in chunks of at most a few
+ *  kilobytes that end at a line break where possible. A character that
+ *  cannot be converted is copied as is, the rest of the text is still
+ *  converted.
+ */
+// note: function is not reentrant!
+static void encodeForOutput(FTextStream &t,RTFBraceChecker &checker,const char *s,int l)
+{
+  if (s==0 || l==0) return;
+  const int chunkSize = 4096;
+  static char enc[chunkSize*4]; // worst case
+  QCString encoding;
+  encoding.sprintf("CP%s",theTranslator->trRTFansicp().data());
+  // convert from UTF-8 back to the output encoding
+  void *cd = portable_iconv_open(encoding,"UTF-8");
+  bool multiByte = FALSE;
+  const char *p = s, *end = s+l;
+  while (p<end)
+  {
+    int n = QMIN(chunkSize,(int)(end-p));
+    if (p+n<end) // split at the last line break in the chunk
+    {
+      int i=n;
+      while (i>0 && p[i-1]!='\n') i--;
+      if (i>0)
+      {
+        n=i;
+      }
+      else // no line break, do not split a UTF-8 sequence
+      {
+        while (n>1 && ((uchar)p[n]&0xC0)==0x80) n--;
+      }
+    }
+    if (cd==(void *)(-1)) // no conversion possible, copy as is
+    {
+      writeEscaped(t,checker,p,n,multiByte);
+    }
+    else
+    {
+      char *inputPtr = (char*)p;
+      size_t iLeft = n;
+      while (iLeft>0)
+      {
+        char *outputPtr = enc;
+        size_t oLeft = sizeof(enc);
+        size_t r = portable_iconv(cd,&inputPtr,&iLeft,&outputPtr,&oLeft);
+        writeEscaped(t,checker,enc,(int)(outputPtr-enc),multiByte);
+        if (r==(size_t)(-1) && errno!=E2BIG && iLeft>0)
+        {
+          // invalid or unrepresentable character: copy its bytes as is
+          uchar c = (uchar)*inputPtr;
+          size_t bad = c>=0xF0 ? 4 : c>=0xE0 ? 3 : c>=0xC0 ? 2 : 1;
+          if (bad>iLeft) bad=iLeft;
+          writeEscaped(t,checker,inputPtr,(int)bad,multiByte);
+          inputPtr+=bad;
+          iLeft-=bad;
+          portable_iconv(cd,0,0,0,0); // reset the conversion state
+        }
+      }
+    }
+    p+=n;
+  }
+  if (cd!=(void *)(-1)) portable_iconv_close(cd);
+}
+
 /**
  * VERY brittle routine inline RTF's included by other RTF's.
  * it is recursive and ugly.
  */
-static bool preProcessFile(QDir &d,QCString &infName, FTextStream &t, bool bIncludeHeader=TRUE)
+static bool preProcessFile(QDir &d,QCString &infName, FTextStream &t, 
+                           RTFBraceChecker &checker, bool bIncludeHeader=TRUE)
 {
   QFile f(infName);
   if (!f.open(IO_ReadOnly))
@@ -2355,65 +2441,73 @@ static bool preProcessFile(QDir &d,QCString &infName, FTextStream &t, bool bIncl
     return FALSE;
   }
 
-  const int maxLineLength = 10240;
-  static QCString lineBuf(maxLineLength);
+  // read the file in one go, so lines can have any length
+  uint size = f.size();
+  QCString contents(size+1);
+  if (size>0 && f.readBlock(contents.rawData(),size)!=(int)size)
+  {
+    err("read error in %s!\n",infName.data());
+    return FALSE;
+  }
+  contents.at(size)='\0';
+  f.close();
+  const char *data = contents.data();
 
   // scan until find end of header
   // this is EXTREEEEEEEMLY brittle.  It works on OUR rtf
   // files because the first line before the body
   // ALWAYS contains "{\comment begin body}"
-  int len;
-  do
+  int bodyPos = contents.find("\\comment begin body");
+  if (bodyPos==-1)
   {
-    lineBuf.resize(maxLineLength);
-    if ((len=f.readLine(lineBuf.rawData(),maxLineLength))==-1)
-    {
-      err("read error in %s before end of RTF header!\n",infName.data());
-      return FALSE;
-    }
-    lineBuf.resize(len+1);
-    if (bIncludeHeader) encodeForOutput(t,lineBuf.data());
-  } while (lineBuf.find("\\comment begin body")==-1);
-
+    err("read error in %s before end of RTF header!\n",infName.data());
+    return FALSE;
+  }
+  const char *nl = (const char *)memchr(data+bodyPos,'\n',size-bodyPos);
+  uint bodyStart = nl ? (uint)(nl-data+1) : size;
+  if (bIncludeHeader) encodeForOutput(t,checker,data,bodyStart);
 
-  lineBuf.resize(maxLineLength);
-  while ((len=f.readLine(lineBuf.rawData(),maxLineLength))!=-1)
+  // the text between the lines with INCLUDETEXT is written in one block
+  uint start = bodyStart; // start of the text that still needs to be written
+  uint p     = bodyStart; // start of the current line
+  int incPos = contents.find("INCLUDETEXT",bodyStart);
+  while (p<size)
   {
-    lineBuf.resize(len+1);
-    int pos;
-    if ((pos=lineBuf.find("INCLUDETEXT"))!=-1)
+    nl = (const char *)memchr(data+p,'\n',size-p);
+    uint e = nl ? (uint)(nl-data+1) : size; // end of the current line
+    if (incPos!=-1 && (uint)incPos<e)
     {
-      int startNamePos  = lineBuf.find('"',pos)+1;
-      int endNamePos    = lineBuf.find('"',startNamePos);
-      QCString fileName = lineBuf.mid(startNamePos,endNamePos-startNamePos);
+      encodeForOutput(t,checker,data+start,p-start);
+      QCString line(data+p,e-p+1);
+      int pos = incPos-p;
+      int startNamePos  = line.find('"',pos)+1;
+      int endNamePos    = line.find('"',startNamePos);
+      QCString fileName = line.mid(startNamePos,endNamePos-startNamePos);
       DBG_RTF(t << "{\\comment begin include " << fileName << "}" << endl)
-      if (!preProcessFile(d,fileName,t,FALSE)) return FALSE;
+      if (!preProcessFile(d,fileName,t,checker,FALSE)) return FALSE;
       DBG_RTF(t << "{\\comment end include " << fileName << "}" << endl)
+      start  = e;
+      incPos = contents.find("INCLUDETEXT",e);
     }
-    else // no INCLUDETEXT on this line
+    else if (e==size && !bIncludeHeader) // last line of included file
     {
-      // elaborate hoopla to skip  the final "}" if we didn't include the
+      // elaborate hoopla to skip the final "}" if we didn't include the
       // headers
-      if (!f.atEnd() || bIncludeHeader)
+      int pos = contents.findRev('}');
+      if (pos>=(int)p)
       {
-        encodeForOutput(t,lineBuf);
+        encodeForOutput(t,checker,data+start,pos-start);
       }
-      else // last line of included file
+      else
       {
-        // null terminate at the last '}'
-        //char *str = strrchr(buffer,'}');
-        int pos = lineBuf.findRev('}');
-
-        if (pos != -1)
-          lineBuf.at(pos) = '\0';
-        else
-          err("Strange, the last char was not a '}'\n");
-        encodeForOutput(t,lineBuf);
+        err("Strange, the last char was not a '}'\n");
+        encodeForOutput(t,checker,data+start,e-start);
       }
+      start = e;
     }
-    lineBuf.resize(maxLineLength);
+    p = e;
   }
-  f.close();
+  encodeForOutput(t,checker,data+start,size-start);
   // remove temporary file
   d.remove(infName);
   return TRUE;
@@ -2520,48 +2614,13 @@ void RTFGenerator::endDirDepGraph(const DotDirDeps &g)
   DBG_RTF(t << "{\\comment (endDirDepGraph)}"    << endl)
 }
 
-/** Tests the integrity of the result by counting brackets.
- *
- */
-void testRTFOutput(const char *name)
+/** Reports the result of the integrity test of the RTF output \a name. */
+static void testRTFOutput(const RTFBraceChecker &checker,const char *name)
 {
-  int bcount=0;
-  int line=1;
-  int c;
-  QFile f(name);
-  if (f.open(IO_ReadOnly))
-  {
-    while ((c=f.getch())!=-1)
-    {
-      if (c=='\\') // escape char
-      {
-        c=f.getch();
-        if (c==-1) break;
-      }
-      else if (c=='{') // open bracket
-      {
-        bcount++;
-      }
-      else if (c=='}') // close bracket
-      {
-        bcount--;
-        if (bcount<0)
-        {
-          goto err;
-          break;
-        }
-      }
-      else if (c=='\n') // newline
-      {
-        line++;
-      }
-    }
-  }
-  if (bcount==0) return; // file is OK.
-err:
+  if (checker.isBalanced()) return; // file is OK.
   err("RTF integrity test failed at line %d of %s due to a bracket mismatch.\n"
       "       Please try to create a small code example that produces this error \n"
-      "       and send that to dimitri@stack.nl.\n",line,name);
+      "       and send that to dimitri@stack.nl.\n",checker.errorLine(),name);
 }
 
 /**
@@ -2594,7 +2653,9 @@ bool RTFGenerator::preProcessFileInplace(const char *path,const char *name)
   }
   FTextStream outt(&outf);
 
-  if (!preProcessFile(thisDir,mainRTFName,outt))
+  // the integrity of the result is checked while it is written
+  RTFBraceChecker checker;
+  if (!preProcessFile(thisDir,mainRTFName,outt,checker))
   {
     // it failed, remove the temp file
     outf.close();
@@ -2608,7 +2669,7 @@ bool RTFGenerator::preProcessFileInplace(const char *path,const char *name)
   thisDir.remove(mainRTFName);
   thisDir.rename(combinedName,mainRTFName);
 
-  testRTFOutput(mainRTFName);
+  testRTFOutput(checker,mainRTFName);
 
   QDir::setCurrent(oldDir);
   return TRUE;
@@ -25,6 +25,11 @@
  *  This is the language parser for doxygen. It is somewhat fuzzy and
  *  supports C++ and various languages that are closely related to C++, 
  *  such as C, C#, Objective-C, Java, PHP, and IDL.
+ *
+ *  The scanner keeps its state in static variables, so it is not
+ *  reentrant. parseInput(), parsePrototype(), parseCode() and
+ *  resetCodeParserState() must not be called from several threads
+ *  at the same time, not even on different instances.
  */
 class CLanguageScanner : public ParserInterface
 {
@@ -37,8 +37,10 @@
 #include "groupdef.h"
 #include "pagedef.h"
 #include "dirdef.h"
+#include "sortdict.h"
 
 #include <qdir.h>
+#include <qdict.h>
 #include <string.h>
 #include <sqlite3.h>
 
@@ -52,8 +54,6 @@ const char * schema_queries[][2] = {
       "local INTEGER NOT NULL,"
       "id_src INTEGER NOT NULL,"
       "id_dst INTEGER NOT NULL);"
-    "CREATE UNIQUE INDEX idx_includes ON includes "
-      "(local, id_src, id_dst);"
   },
   { "innerclass",
     "CREATE TABLE IF NOT EXISTS innerclass ("
@@ -78,8 +78,6 @@ const char * schema_queries[][2] = {
       "id_file INTEGER NOT NULL, "
       "line INTEGER NOT NULL, "
       "column INTEGER NOT NULL);"
-    "CREATE UNIQUE INDEX idx_xrefs ON xrefs "
-      "(refid_src, refid_dst, id_file, line, column);"
   },
   { "memberdef",
     "CREATE TABLE IF NOT EXISTS memberdef ("
@@ -178,6 +176,19 @@ const char * schema_queries[][2] = {
   }
 };
 
+// indexes are created after all rows are inserted, so the inserts do
+// not have to maintain them
+const char * index_queries[][2] = {
+  { "idx_includes",
+    "CREATE UNIQUE INDEX IF NOT EXISTS idx_includes ON includes "
+      "(local, id_src, id_dst);"
+  },
+  { "idx_xrefs",
+    "CREATE UNIQUE INDEX IF NOT EXISTS idx_xrefs ON xrefs "
+      "(refid_src, refid_dst, id_file, line, column);"
+  }
+};
+
 //////////////////////////////////////////////////////
 struct SqlStmt {
   const char   *query;
@@ -190,10 +201,6 @@ SqlStmt incl_insert = { "INSERT INTO includes "
     "(:local,:id_src,:id_dst )"
     ,NULL
 };
-SqlStmt incl_select = { "SELECT COUNT(*) FROM includes WHERE "
-  "local=:local AND id_src=:id_src AND id_dst=:id_dst"
-    ,NULL
-};
 //////////////////////////////////////////////////////
 SqlStmt innerclass_insert={"INSERT INTO innerclass "
     "( refid, prot, name )"
@@ -202,9 +209,6 @@ SqlStmt innerclass_insert={"INSERT INTO innerclass "
     ,NULL
 };
 //////////////////////////////////////////////////////
-SqlStmt files_select = {"SELECT rowid FROM files WHERE name=:name"
-  ,NULL
-};
 SqlStmt files_insert = {"INSERT INTO files "
   "( name )"
     "VALUES "
@@ -212,10 +216,6 @@ SqlStmt files_insert = {"INSERT INTO files "
     ,NULL
 };
 //////////////////////////////////////////////////////
-SqlStmt refids_select =  {"SELECT rowid FROM refids WHERE "
-  "refid=:refid"
-    ,NULL
-};
 SqlStmt refids_insert = {"INSERT INTO refids "
   "( refid )"
     "VALUES "
@@ -349,34 +349,134 @@ static int step(sqlite3 *db, SqlStmt &s,bool getRowId=FALSE, bool select=FALSE)
   return rowid;
 }
 
-static int insertFile(sqlite3 *db, const char* name)
+// the row ids of the files and refids inserted so far, so each name
+// is looked up in memory instead of with a query. The dictionaries
+// grow with the number of names, see insertName().
+static QDict<int> g_fileIds(SDict_primes[9]);
+static QDict<int> g_refidIds(SDict_primes[9]);
+
+/** @brief Set of rows given as tuples of integers.
+ *
+ *  Used to skip rows that were inserted before, without building a key
+ *  string. The set uses open addressing and doubles its table when it
+ *  gets half full.
+ */
+class RowKeySet
 {
-  int rowid=-1;
-  if (name==0) return rowid;
+  public:
+    RowKeySet(int width) 
+      : m_width(width), m_count(0), m_mask(0), m_hashes(0), m_keys(0) {}
+   ~RowKeySet() { clear(); }
+    /** Adds the row \a key, an array of width integers. Returns FALSE
+     *  if the row was already in the set.
+     */
+    bool insert(const int *key)
+    {
+      if ((m_count+1)*2>m_mask+1) grow();
+      uint h = hash(key);
+      uint i = h & m_mask;
+      while (m_hashes[i])
+      {
+        if (m_hashes[i]==h && 
+            memcmp(&m_keys[i*m_width],key,m_width*sizeof(int))==0)
+        {
+          return FALSE;
+        }
+        i = (i+1) & m_mask;
+      }
+      m_hashes[i] = h;
+      memcpy(&m_keys[i*m_width],key,m_width*sizeof(int));
+      m_count++;
+      return TRUE;
+    }
+    void clear()
+    {
+      free(m_hashes); m_hashes=0;
+      free(m_keys);   m_keys=0;
+      m_count=0;
+      m_mask=0;
+    }
+  private:
+    uint hash(const int *key) const
+    {
+      uint h = 0;
+      int i;
+      for (i=0;i<m_width;i++) h = (h^(uint)key[i])*2654435761u;
+      return (h^(h>>15))|1; // 0 marks an empty slot
+    }
+    void grow()
+    {
+      uint oldSize = m_hashes ? m_mask+1 : 0;
+      uint newSize = oldSize ? oldSize*2 : 1024;
+      uint *hashes = (uint *)calloc(newSize,sizeof(uint));
+      int  *keys   = (int *)malloc(newSize*m_width*sizeof(int));
+      uint i;
+      for (i=0;i<oldSize;i++)
+      {
+        if (m_hashes[i])
+        {
+          uint j = m_hashes[i] & (newSize-1);
+          while (hashes[j]) j = (j+1) & (newSize-1);
+          hashes[j] = m_hashes[i];
+          memcpy(&keys[j*m_width],&m_keys[i*m_width],m_width*sizeof(int));
+        }
+      }
+      free(m_hashes);
+      free(m_keys);
+      m_hashes = hashes;
+      m_keys   = keys;
+      m_mask   = newSize-1;
+    }
+    int   m_width;
+    uint  m_count;
+    uint  m_mask;
+    uint *m_hashes;
+    int  *m_keys;
+};
 
-  bindTextParameter(files_select,":name",name);
-  rowid=step(db,files_select,TRUE,TRUE);
-  if (rowid==0)
+// the include and xref rows inserted so far, to skip duplicates
+static RowKeySet g_includeKeys(3);
+static RowKeySet g_xrefKeys(4);
+
+static int insertName(sqlite3 *db, SqlStmt &insert, const char *param,
+                      QDict<int> &ids, const char *name)
+{
+  if (name==0) return -1;
+  int *id = ids.find(name);
+  if (id) return *id;
+  bindTextParameter(insert,param,name);
+  int rowid=step(db,insert,TRUE);
+  if (rowid!=-1)
   {
-    bindTextParameter(files_insert,":name",name);
-    rowid=step(db,files_insert,TRUE);
+    ids.insert(name,new int(rowid));
+    if (ids.count()>ids.size()) // keep the hash chains short
+    {
+      int i=0;
+      while (SDict_primes[i]<ids.count()*2) i++;
+      ids.resize(SDict_primes[i]);
+    }
   }
   return rowid;
 }
 
+static int insertFile(sqlite3 *db, const char* name)
+{
+  return insertName(db,files_insert,":name",g_fileIds,name);
+}
+
 static int insertRefid(sqlite3 *db, const char *refid)
 {
-  int rowid=-1;
-  if (refid==0) return rowid;
+  return insertName(db,refids_insert,":refid",g_refidIds,refid);
+}
 
-  bindTextParameter(refids_select,":refid",refid);
-  rowid=step(db,refids_select,TRUE,TRUE);
-  if (rowid==0)
-  {
-    bindTextParameter(refids_insert,":refid",refid);
-    rowid=step(db,refids_insert,TRUE);
-  }
-  return rowid;
+static void insertInclude(sqlite3 *db, bool local, int id_src, int id_dst)
+{
+  int key[3] = { local, id_src, id_dst };
+  if (!g_includeKeys.insert(key)) return;
+  bindIntParameter(incl_insert,":local",local);
+  bindIntParameter(incl_insert,":id_src",id_src);
+  bindIntParameter(incl_insert,":id_dst",id_dst);
+  step(db,incl_insert);
 }
 
 
@@ -387,6 +487,8 @@ static void insertMemberReference(sqlite3 *db, const char*src, const char*dst, c
   int refid_dst = insertRefid(db,dst);
   if (id_file==-1||refid_src==-1||refid_dst==-1)
     return;
+  int key[4] = { refid_src, refid_dst, id_file, line };
+  if (!g_xrefKeys.insert(key)) return;
 
   bindIntParameter(xrefs_insert,":refid_src",refid_src);
   bindIntParameter(xrefs_insert,":refid_dst",refid_dst);
@@ -538,11 +640,8 @@ static int prepareStatements(sqlite3 *db)
   if (
   -1==prepareStatement(db, memberdef_insert) ||
   -1==prepareStatement(db, files_insert) ||
-  -1==prepareStatement(db, files_select) ||
   -1==prepareStatement(db, refids_insert) ||
-  -1==prepareStatement(db, refids_select) ||
   -1==prepareStatement(db, incl_insert)||
-  -1==prepareStatement(db, incl_select)||
   -1==prepareStatement(db, params_insert) ||
   -1==prepareStatement(db, params_select) ||
   -1==prepareStatement(db, xrefs_insert) ||
@@ -606,6 +705,23 @@ static int initializeSchema(sqlite3* db)
   return 0;
 }
 
+static int createIndexes(sqlite3* db)
+{
+  char *sErrMsg = 0;
+  msg("Creating DB indexes...\n");
+  for (unsigned int k = 0; k < sizeof(index_queries) / sizeof(index_queries[0]); k++)
+  {
+    const char *q = index_queries[k][1];
+    if (sqlite3_exec(db, q, NULL, NULL, &sErrMsg) != SQLITE_OK)
+    {
+      msg("failed to execute query: %s\n\t%s\n", q, sErrMsg);
+      sqlite3_free(sErrMsg);
+      return -1;
+    }
+  }
+  return 0;
+}
+
 ////////////////////////////////////////////
 static void writeInnerClasses(sqlite3*db,const ClassSDict *cl)
 {
@@ -1046,17 +1162,7 @@ static void generateSqlite3ForClass(sqlite3 *db, ClassDef *cd)
     {
       int id_dst=insertFile(db,nm);
       if (id_dst!=-1) {
-        bindIntParameter(incl_select,":local",ii->local);
-        bindIntParameter(incl_select,":id_src",id_file);
-        bindIntParameter(incl_select,":id_dst",id_dst);
-        int count=step(db,incl_select,TRUE,TRUE);
-        if (count==0)
-        {
-          bindIntParameter(incl_insert,":local",ii->local);
-          bindIntParameter(incl_insert,":id_src",id_file);
-          bindIntParameter(incl_insert,":id_dst",id_dst);
-          step(db,incl_insert);
-        }
+        insertInclude(db,ii->local,id_file,id_dst);
       }
     }
   }
@@ -1160,15 +1266,7 @@ static void generateSqlite3ForFile(sqlite3 *db, FileDef *fd)
     {
       int id_src=insertFile(db,fd->absFilePath().data());
       int id_dst=insertFile(db,ii->includeName.data());
-      bindIntParameter(incl_select,":local",ii->local);
-      bindIntParameter(incl_select,":id_src",id_src);
-      bindIntParameter(incl_select,":id_dst",id_dst);
-      if (step(db,incl_select,TRUE,TRUE)==0) {
-        bindIntParameter(incl_insert,":local",ii->local);
-        bindIntParameter(incl_insert,":id_src",id_src);
-        bindIntParameter(incl_insert,":id_dst",id_dst);
-        step(db,incl_insert);
-      }
+      insertInclude(db,ii->local,id_src,id_dst);
     }
   }
 
@@ -1180,15 +1278,7 @@ static void generateSqlite3ForFile(sqlite3 *db, FileDef *fd)
     {
       int id_src=insertFile(db,ii->includeName);
       int id_dst=insertFile(db,fd->absFilePath());
-      bindIntParameter(incl_select,":local",ii->local);
-      bindIntParameter(incl_select,":id_src",id_src);
-      bindIntParameter(incl_select,":id_dst",id_dst);
-      if (step(db,incl_select,TRUE,TRUE)==0) {
-        bindIntParameter(incl_insert,":local",ii->local);
-        bindIntParameter(incl_insert,":id_src",id_src);
-        bindIntParameter(incl_insert,":id_dst",id_dst);
-        step(db,incl_insert);
-      }
+      insertInclude(db,ii->local,id_src,id_dst);
     }
   }
 
@@ -1258,6 +1348,9 @@ void generateSqlite3()
   QDir sqlite3Dir(outputDirectory);
   sqlite3 *db;
   sqlite3_initialize();
+  // start from an empty database, the id caches below assume all rows
+  // are inserted by this run
+  sqlite3Dir.remove("doxygen_sqlite3.db");
   int rc = sqlite3_open_v2(outputDirectory+"/doxygen_sqlite3.db", &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, 0);
   if (rc != SQLITE_OK)
   {
@@ -1265,8 +1358,12 @@ void generateSqlite3()
     msg("database open failed: %s\n", "doxygen_sqlite3.db");
     return;
   }
-  beginTransaction(db);
+  // the journal mode cannot be changed inside a transaction
   pragmaTuning(db);
+  beginTransaction(db);
+
+  g_fileIds.setAutoDelete(TRUE);
+  g_refidIds.setAutoDelete(TRUE);
 
   if (-1==initializeSchema(db))
     return;
@@ -1358,7 +1455,13 @@ void generateSqlite3()
     generateSqlite3ForPage(db,Doxygen::mainPage,FALSE);
   }
 
+  createIndexes(db);
   endTransaction(db);
+
+  g_fileIds.clear();
+  g_refidIds.clear();
+  g_includeKeys.clear();
+  g_xrefKeys.clear();
 }
 
 #else // USE_SQLITE3
@@ -0,0 +1,302 @@
+/******************************************************************************
+ *
+ *
+ *
+ * Copyright (C) 1997-2015 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <qcstring.h>
+#include "symboltable.h"
+#ifndef SYMTAB_TEST
+#include "message.h"
+#endif
+
+//----------------------------------------------------------------------
+
+SymbolTable::SymbolTable()
+  : m_numSymbols(0), m_symbolsSize(1024), m_slotMask(4096-1), m_record(0),
+    m_lookups(0), m_misses(0), m_probes(0)
+{
+  m_symbols = (Symbol *)malloc(m_symbolsSize*sizeof(Symbol));
+  m_slots   = (int *)malloc((m_slotMask+1)*sizeof(int));
+  memset(m_slots,-1,(m_slotMask+1)*sizeof(int));
+}
+
+SymbolTable::~SymbolTable()
+{
+  int i;
+  for (i=0;i<m_numSymbols;i++)
+  {
+    delete[] m_symbols[i].name; // allocated by qstrdup()
+    free(m_symbols[i].defs);
+    free(m_symbols[i].chain);
+  }
+  free(m_symbols);
+  free(m_slots);
+  if (m_record) fclose(m_record);
+}
+
+uint SymbolTable::hashName(const char *name)
+{
+  // FNV-1a
+  uint h = 2166136261u;
+  const uchar *p = (const uchar *)name;
+  uchar c;
+  while ((c=*p++)) { h^=c; h*=16777619u; }
+  return h;
+}
+
+/** Returns the slot that holds \a name or else the empty slot where it
+ *  should be inserted.
+ */
+int SymbolTable::findSlot(const char *name,uint hash) const
+{
+  uint i = hash & m_slotMask;
+  int id;
+  while ((id=m_slots[i])!=-1)
+  {
+    if (m_symbols[id].hash==hash && qstrcmp(m_symbols[id].name,name)==0) break;
+    i = (i+1) & m_slotMask; // linear probing
+  }
+  return (int)i;
+}
+
+void SymbolTable::growTable()
+{
+  free(m_slots);
+  m_slotMask = m_slotMask*2+1;
+  m_slots = (int *)malloc((m_slotMask+1)*sizeof(int));
+  memset(m_slots,-1,(m_slotMask+1)*sizeof(int));
+  int id;
+  for (id=0;id<m_numSymbols;id++)
+  {
+    m_slots[findSlot(m_symbols[id].name,m_symbols[id].hash)] = id;
+  }
+}
+
+int SymbolTable::intern(const char *name)
+{
+  uint hash = hashName(name);
+  int slot = findSlot(name,hash);
+  if (m_slots[slot]!=-1) return m_slots[slot];
+
+  if (m_numSymbols==m_symbolsSize)
+  {
+    m_symbolsSize*=2;
+    m_symbols = (Symbol *)realloc(m_symbols,m_symbolsSize*sizeof(Symbol));
+  }
+  int id = m_numSymbols++;
+  Symbol *s = &m_symbols[id];
+  s->name  = qstrdup(name);
+  s->hash  = hash;
+  s->defs  = 0;
+  s->count = 0;
+  s->size  = 0;
+  s->chain = 0;
+  s->chainLength = -1;
+  m_slots[slot] = id;
+  if ((uint)m_numSymbols*2>m_slotMask) growTable(); // keep the load below 50%
+  return id;
+}
+
+int SymbolTable::findId(const char *name) const
+{
+  if (name==0) return -1;
+  return m_slots[findSlot(name,hashName(name))];
+}
+
+void SymbolTable::add(int id,Definition *d)
+{
+  Symbol *s = &m_symbols[id];
+  if (s->count==s->size)
+  {
+    s->size = s->size==0 ? 2 : s->size*2;
+    s->defs = (Definition **)realloc(s->defs,s->size*sizeof(Definition*));
+  }
+  s->defs[s->count++] = d;
+  if (m_record) fprintf(m_record,"A %p %s\n",(void*)d,s->name);
+}
+
+void SymbolTable::remove(int id,Definition *d)
+{
+  Symbol *s = &m_symbols[id];
+  int i;
+  for (i=0;i<s->count;i++)
+  {
+    if (s->defs[i]==d) // keep the order of the remaining definitions
+    {
+      memmove(&s->defs[i],&s->defs[i+1],(s->count-i-1)*sizeof(Definition*));
+      s->count--;
+      if (m_record) fprintf(m_record,"R %p %s\n",(void*)d,s->name);
+      break;
+    }
+  }
+}
+
+void SymbolTable::setScopeChain(int id,const int *parts,int count)
+{
+  Symbol *s = &m_symbols[id];
+  free(s->chain);
+  s->chain = (int *)malloc(QMAX(count,1)*sizeof(int));
+  memcpy(s->chain,parts,count*sizeof(int));
+  s->chainLength = count;
+}
+
+int SymbolTable::lookup(const char *name)
+{
+  m_lookups++;
+  if (m_record) fprintf(m_record,"L %s\n",name);
+  int id = findId(name);
+  if (id==-1 || m_symbols[id].count==0)
+  {
+    m_misses++;
+    return -1;
+  }
+  m_probes += m_symbols[id].count;
+  return id;
+}
+
+bool SymbolTable::startRecording(const char *fileName)
+{
+  if (m_record) fclose(m_record);
+  m_record = fopen(fileName,"w");
+  if (m_record==0) return FALSE;
+  int id,i;
+  for (id=0;id<m_numSymbols;id++)
+  {
+    for (i=0;i<m_symbols[id].count;i++)
+    {
+      fprintf(m_record,"A %p %s\n",(void*)m_symbols[id].defs[i],m_symbols[id].name);
+    }
+  }
+  return TRUE;
+}
+
+void SymbolTable::printStats() const
+{
+#ifndef SYMTAB_TEST
+  msg("symbol table: %d names, %d lookups, %d misses, %.2f candidates per hit\n",
+      m_numSymbols,m_lookups,m_misses,
+      m_lookups>m_misses ? (double)m_probes/(m_lookups-m_misses) : 0.0);
+#endif
+}
+
+//----------------------------------------------------------------------
+
+#ifdef SYMTAB_TEST
+// Replays a file written by SymbolTable::startRecording() (doxygen -d symbols)
+// and compares the results and the lookup time against a QDict of lists,
+// which is how Doxygen::symbolMap stores the same data.
+#include <time.h>
+#include <qdict.h>
+#include <qlist.h>
+
+int main(int argc,char **argv)
+{
+  if (argc<2)
+  {
+    printf("Usage: %s symbollookups.log [repeat]\n",argv[0]);
+    return 1;
+  }
+  FILE *f = fopen(argv[1],"r");
+  if (f==0) { printf("cannot open %s\n",argv[1]); return 1; }
+  int repeat = argc>2 ? atoi(argv[2]) : 10;
+
+  SymbolTable table;
+  QDict< QList<char> > dict(50177);
+  dict.setAutoDelete(TRUE);
+  QDict<char> ptrMap(10007);
+  QList<QCString> lookups;
+  lookups.setAutoDelete(TRUE);
+  long nextPtr = 16;
+  char line[4096];
+  while (fgets(line,sizeof(line),f))
+  {
+    int l = strlen(line);
+    if (l>0 && line[l-1]=='\n') line[--l]='\0';
+    if (l<3) continue;
+    if (line[0]=='L')
+    {
+      lookups.append(new QCString(line+2));
+      continue;
+    }
+    char *name = strchr(line+2,' ');
+    if (name==0) continue;
+    *name++='\0';
+    char *p = ptrMap.find(line+2);
+    if (p==0)
+    {
+      p = (char *)(nextPtr+=16);
+      ptrMap.insert(line+2,p);
+    }
+    int id = table.intern(name);
+    QList<char> *list = dict.find(name);
+    if (line[0]=='A')
+    {
+      table.add(id,(Definition*)p);
+      if (list==0) { list = new QList<char>; dict.insert(name,list); }
+      list->append(p);
+    }
+    else if (line[0]=='R')
+    {
+      table.remove(id,(Definition*)p);
+      if (list) list->removeRef(p);
+    }
+  }
+  fclose(f);
+
+  long sumTable=0,sumDict=0;
+  int r;
+  clock_t t = clock();
+  for (r=0;r<repeat;r++)
+  {
+    QListIterator<QCString> li(lookups);
+    QCString *s;
+    for (;(s=li.current());++li)
+    {
+      int id = table.lookup(s->data());
+      if (id!=-1)
+      {
+        Definition *d;
+        int i;
+        for (i=0;(d=table.definition(id,i));i++) sumTable+=(long)d*(i+1);
+      }
+    }
+  }
+  double tTable = (double)(clock()-t)/CLOCKS_PER_SEC;
+  t = clock();
+  for (r=0;r<repeat;r++)
+  {
+    QListIterator<QCString> li(lookups);
+    QCString *s;
+    for (;(s=li.current());++li)
+    {
+      QList<char> *list = dict.find(*s);
+      if (list)
+      {
+        QListIterator<char> di(*list);
+        char *p;
+        int i;
+        for (i=1;(p=di.current());++di,++i) sumDict+=(long)p*i;
+      }
+    }
+  }
+  double tDict = (double)(clock()-t)/CLOCKS_PER_SEC;
+  printf("%d lookups x %d: symbol table %.3fs, dictionary %.3fs, %s\n",
+      lookups.count(),repeat,tTable,tDict,
+      sumTable==sumDict ? "same results" : "DIFFERENT RESULTS");
+  return sumTable==sumDict ? 0 : 1;
+}
+#endif
@@ -0,0 +1,122 @@
+/******************************************************************************
+ *
+ *
+ *
+ * Copyright (C) 1997-2015 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef SYMBOLTABLE_H
+#define SYMBOLTABLE_H
+
+//#define SYMTAB_TEST
+
+#include <stdio.h>
+#include <qglobal.h>
+
+class Definition;
+
+/** @brief Table of symbol names, used to resolve names to definitions.
+ *
+ *  Each symbol name is interned once and identified by a small integer
+ *  id from then on. Names are found through an open addressed hash table
+ *  that stores the id of each name; the hash value of the name is kept
+ *  next to it, so a probe only compares strings when the hashes match.
+ *  All definitions that share a name are stored in one contiguous array,
+ *  in the order in which they were added.
+ *
+ *  The table holds the same symbols as Doxygen::symbolMap and is kept up
+ *  to date by Definition. It is used by the lookups that resolve class,
+ *  typedef and member names.
+ *
+ *  A name can also carry a scope chain: the ids of the parts of a scope
+ *  path such as \c A::B<T>::C. The chain is stored once per name, so code
+ *  that follows an explicit scope can walk the ids instead of splitting
+ *  and comparing the path each time.
+ */
+class SymbolTable
+{
+  public:
+    SymbolTable();
+   ~SymbolTable();
+
+    /** Returns the id of \a name, adding the name if it is new. */
+    int intern(const char *name);
+    /** Returns the id of \a name, or -1 if the name is unknown. */
+    int findId(const char *name) const;
+    /** Returns the name with id \a id. */
+    const char *name(int id) const { return m_symbols[id].name; }
+
+    /** Adds definition \a d for the name with id \a id. */
+    void add(int id,Definition *d);
+    /** Removes definition \a d from the name with id \a id. */
+    void remove(int id,Definition *d);
+
+    /** Looks up \a name for name resolution. Returns the id of the name,
+     *  or -1 if there are no definitions with this name.
+     */
+    int lookup(const char *name);
+    /** Returns the number of definitions for the name with id \a id. */
+    int count(int id) const { return m_symbols[id].count; }
+    /** Returns definition \a index for the name with id \a id, or 0 if
+     *  \a index is out of range. Definitions may be added while the list
+     *  is being walked, so callers iterate by index.
+     */
+    Definition *definition(int id,int index) const
+    {
+      return index<m_symbols[id].count ? m_symbols[id].defs[index] : 0;
+    }
+
+    /** Returns TRUE if a scope chain was set for the name with id \a id. */
+    bool hasScopeChain(int id) const { return m_symbols[id].chainLength!=-1; }
+    /** Sets the scope chain of the name with id \a id to the \a count
+     *  ids in \a parts.
+     */
+    void setScopeChain(int id,const int *parts,int count);
+    /** Returns the number of parts in the scope chain of \a id. */
+    int scopeChainLength(int id) const { return m_symbols[id].chainLength; }
+    /** Returns the id of part \a index of the scope chain of \a id. */
+    int scopeChainPart(int id,int index) const { return m_symbols[id].chain[index]; }
+
+    /** Writes all symbols, and from then on all changes and lookups, to
+     *  \a fileName. The file can be replayed by the SYMTAB_TEST driver.
+     */
+    bool startRecording(const char *fileName);
+    void printStats() const;
+
+  private:
+    struct Symbol
+    {
+      char *name;
+      uint hash;
+      Definition **defs;
+      int count;
+      int size;
+      int *chain;        // scope chain, see setScopeChain()
+      int chainLength;   // -1 if no chain was set
+    };
+    static uint hashName(const char *name);
+    int  findSlot(const char *name,uint hash) const;
+    void growTable();
+
+    Symbol *m_symbols;   // indexed by id
+    int  m_numSymbols;
+    int  m_symbolsSize;
+    int *m_slots;        // hash table of ids, -1 for an empty slot
+    uint m_slotMask;
+    FILE *m_record;
+    int  m_lookups;
+    int  m_misses;
+    int  m_probes;
+};
+
+#endif
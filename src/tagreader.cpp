@@ -20,11 +20,13 @@
 
 #include <stdio.h>
 #include <stdarg.h>
+#include <string.h>
 
 #include <qxml.h>
 #include <qstack.h>
 #include <qdict.h>
 #include <qfileinfo.h>
+#include <qdir.h>
 #include <qlist.h>
 #include <qstring.h>
 #include <qstringlist.h>
@@ -39,6 +41,9 @@
 #include "filedef.h"
 #include "filename.h"
 #include "section.h"
+#include "config.h"
+#include "marshal.h"
+#include "filestorage.h"
 
 /** Information about an linkable anchor */
 class TagAnchorInfo
@@ -263,6 +268,13 @@ class TagFileParser : public QXmlDefaultHandler
       m_curIncludes=0;
       m_state = Invalid;
       m_locator = 0;
+      m_tagFileClasses.setAutoDelete(TRUE);
+      m_tagFileFiles.setAutoDelete(TRUE);
+      m_tagFileNamespaces.setAutoDelete(TRUE);
+      m_tagFileGroups.setAutoDelete(TRUE);
+      m_tagFilePages.setAutoDelete(TRUE);
+      m_tagFilePackages.setAutoDelete(TRUE);
+      m_tagFileDirs.setAutoDelete(TRUE);
     }
 
     void setDocumentLocator ( QXmlLocator * locator )
@@ -907,8 +919,11 @@ class TagFileParser : public QXmlDefaultHandler
     void dump();
     void buildLists(Entry *root);
     void addIncludes();
+    bool readCache(const QCString &cacheName,const QFileInfo &fi,uint checksum);
+    bool writeCache(const QCString &cacheName,const QFileInfo &fi,uint checksum);
     
   private:
+    void clear();
     void buildMemberList(Entry *ce,QList<TagMemberInfo> &members);
     void addDocAnchors(Entry *e,const TagAnchorInfoList &l);
     QList<TagClassInfo>        m_tagFileClasses;
@@ -1477,6 +1492,18 @@ void TagFileParser::buildLists(Entry *root)
   }
 }
 
+/*! Removes all structures gathered so far. */
+void TagFileParser::clear()
+{
+  m_tagFileClasses.clear();
+  m_tagFileFiles.clear();
+  m_tagFileNamespaces.clear();
+  m_tagFileGroups.clear();
+  m_tagFilePages.clear();
+  m_tagFilePackages.clear();
+  m_tagFileDirs.clear();
+}
+
 void TagFileParser::addIncludes()
 {
   QListIterator<TagFileInfo> fit(m_tagFileFiles);
@@ -1524,11 +1551,532 @@ void TagFileParser::addIncludes()
   }
 }
 
-void parseTagFile(Entry *root,const char *fullName)
+//---------------------------------------------------------------------------
+
+/* The tag file cache is a pre-indexed binary copy of the structures built
+ * by the XML parser. It is stored next to the tag file with the extension
+ * .tagcache, and is only used if it was made from a tag file with the same
+ * size and checksum.
+ */
+
+#define TAGCACHE_MAGIC   "DOXYTAGC"
+#define TAGCACHE_VERSION 3
+
+/** @brief Storage reading from a memory buffer holding a tag file cache.
+ *  Reads past the end of the buffer, and counts or lengths that do not
+ *  fit in the remaining data, are flagged instead of performed.
+ */
+class TagCacheBuffer : public StorageIntf
+{
+  public:
+    TagCacheBuffer(const char *data,uint size) 
+      : m_data(data), m_size(size), m_pos(0), m_error(FALSE) {}
+    int read(char *buf,uint size)
+    {
+      if (m_error || size>m_size-m_pos)
+      {
+        m_error=TRUE;
+        memset(buf,0,size);
+        return -1;
+      }
+      memcpy(buf,m_data+m_pos,size);
+      m_pos+=size;
+      return size;
+    }
+    int write(const char *,uint) { return -1; }
+    bool error() const { return m_error; }
+    bool atEnd() const { return m_pos==m_size; }
+    /*! Reads a list count and checks that it is plausible for the 
+     *  remaining data, which avoids huge loops for a damaged file.
+     *  If \a allowNull is TRUE, NULL_LIST is returned as is.
+     */
+    uint readCount(bool allowNull=FALSE)
+    {
+      uint count = unmarshalUInt(this);
+      if (allowNull && count==NULL_LIST) return count;
+      if (m_error || count>m_size-m_pos) { m_error=TRUE; count=0; }
+      return count;
+    }
+    /*! Reads a string written by marshalQCString(). Unlike 
+     *  unmarshalQCString() the length is checked against the remaining data.
+     */
+    QCString readString()
+    {
+      uint len = unmarshalUInt(this);
+      if (m_error || len>m_size-m_pos) { m_error=TRUE; return QCString(); }
+      QCString result(len+1);
+      result.at(len)='\0';
+      if (len>0)
+      {
+        read(result.rawData(),len);
+      }
+      return result;
+    }
+  private:
+    const char *m_data;
+    uint m_size;
+    uint m_pos;
+    bool m_error;
+};
+
+/*! Returns a checksum (FNV-1a) over the contents of the tag file
+ *  \a fileName. Reading the file is much cheaper than parsing it.
+ */
+static uint tagFileChecksum(const char *fileName)
+{
+  uint h = 2166136261u;
+  QFile f(fileName);
+  if (f.open(IO_ReadOnly))
+  {
+    char buf[65536];
+    int n,i;
+    while ((n=f.readBlock(buf,sizeof(buf)))>0)
+    {
+      for (i=0;i<n;i++) { h^=(uchar)buf[i]; h*=16777619u; }
+    }
+  }
+  return h;
+}
+
+static QCString tagCacheFileName(const char *tagFileName)
+{
+  return QCString(tagFileName)+".tagcache";
+}
+
+static void marshalStringList(StorageIntf *s,const QStringList &l)
+{
+  marshalUInt(s,l.count());
+  QStringList::ConstIterator it;
+  for (it=l.begin();it!=l.end();++it)
+  {
+    marshalQCString(s,(*it).utf8());
+  }
+}
+
+static void unmarshalStringList(TagCacheBuffer *s,QStringList &l)
+{
+  uint i,count = s->readCount();
+  for (i=0;i<count && !s->error();i++)
+  {
+    l.append(s->readString());
+  }
+}
+
+static QList<BaseInfo> *unmarshalBases(TagCacheBuffer *s)
+{
+  uint i,count = s->readCount(TRUE);
+  if (count==NULL_LIST) return 0;
+  QList<BaseInfo> *result = new QList<BaseInfo>;
+  result->setAutoDelete(TRUE);
+  for (i=0;i<count && !s->error();i++)
+  {
+    QCString name   = s->readString();
+    Protection prot = (Protection)unmarshalInt(s);
+    Specifier virt  = (Specifier)unmarshalInt(s);
+    result->append(new BaseInfo(name,prot,virt));
+  }
+  return result;
+}
+
+static void marshalDocAnchors(StorageIntf *s,const TagAnchorInfoList &l)
+{
+  marshalUInt(s,l.count());
+  QListIterator<TagAnchorInfo> ali(l);
+  TagAnchorInfo *ai;
+  for (;(ai=ali.current());++ali)
+  {
+    marshalQCString(s,ai->fileName);
+    marshalQCString(s,ai->label);
+    marshalQCString(s,ai->title);
+  }
+}
+
+static void unmarshalDocAnchors(TagCacheBuffer *s,TagAnchorInfoList &l)
+{
+  uint i,count = s->readCount();
+  for (i=0;i<count && !s->error();i++)
+  {
+    QCString fileName = s->readString();
+    QCString label    = s->readString();
+    QCString title    = s->readString();
+    l.append(new TagAnchorInfo(fileName,label,title));
+  }
+}
+
+static void marshalMembers(StorageIntf *s,const QList<TagMemberInfo> &l)
+{
+  marshalUInt(s,l.count());
+  QListIterator<TagMemberInfo> mii(l);
+  TagMemberInfo *tmi;
+  for (;(tmi=mii.current());++mii)
+  {
+    marshalQCString(s,tmi->type);
+    marshalQCString(s,tmi->name);
+    marshalQCString(s,tmi->anchorFile);
+    marshalQCString(s,tmi->anchor);
+    marshalQCString(s,tmi->arglist);
+    marshalQCString(s,tmi->kind);
+    marshalQCString(s,tmi->clangId);
+    marshalDocAnchors(s,tmi->docAnchors);
+    marshalInt(s,(int)tmi->prot);
+    marshalInt(s,(int)tmi->virt);
+    marshalBool(s,tmi->isStatic);
+    marshalUInt(s,tmi->enumValues.count());
+    QListIterator<TagEnumValueInfo> evii(tmi->enumValues);
+    TagEnumValueInfo *evi;
+    for (;(evi=evii.current());++evii)
+    {
+      marshalQCString(s,evi->name);
+      marshalQCString(s,evi->file);
+      marshalQCString(s,evi->anchor);
+      marshalQCString(s,evi->clangid);
+    }
+  }
+}
+
+static void unmarshalMembers(TagCacheBuffer *s,QList<TagMemberInfo> &l)
+{
+  uint i,j,count = s->readCount();
+  for (i=0;i<count && !s->error();i++)
+  {
+    TagMemberInfo *tmi = new TagMemberInfo;
+    tmi->type       = s->readString();
+    tmi->name       = s->readString();
+    tmi->anchorFile = s->readString();
+    tmi->anchor     = s->readString();
+    tmi->arglist    = s->readString();
+    tmi->kind       = s->readString();
+    tmi->clangId    = s->readString();
+    unmarshalDocAnchors(s,tmi->docAnchors);
+    tmi->prot       = (Protection)unmarshalInt(s);
+    tmi->virt       = (Specifier)unmarshalInt(s);
+    tmi->isStatic   = unmarshalBool(s);
+    uint numValues  = s->readCount();
+    for (j=0;j<numValues && !s->error();j++)
+    {
+      TagEnumValueInfo *evi = new TagEnumValueInfo;
+      evi->name    = s->readString();
+      evi->file    = s->readString();
+      evi->anchor  = s->readString();
+      evi->clangid = s->readString();
+      tmi->enumValues.append(evi);
+    }
+    l.append(tmi);
+  }
+}
+
+/*! Writes the structures built from the tag file \a fi with checksum
+ *  \a checksum to the tag file cache \a cacheName. The cache is first 
+ *  written to a temporary file, so a reader never sees an incomplete cache.
+ */
+bool TagFileParser::writeCache(const QCString &cacheName,const QFileInfo &fi,
+                               uint checksum)
+{
+  QCString tmpName = cacheName+".tmp";
+  FileStorage f(tmpName);
+  if (!f.open(IO_WriteOnly)) return FALSE;
+  StorageIntf *s = &f;
+  s->write(TAGCACHE_MAGIC,8);
+  marshalUInt(s,TAGCACHE_VERSION);
+  marshalUInt(s,fi.size());
+  marshalUInt(s,checksum);
+
+  marshalUInt(s,m_tagFileClasses.count());
+  QListIterator<TagClassInfo> cit(m_tagFileClasses);
+  TagClassInfo *tci;
+  for (cit.toFirst();(tci=cit.current());++cit)
+  {
+    marshalQCString(s,tci->name);
+    marshalQCString(s,tci->filename);
+    marshalQCString(s,tci->clangId);
+    marshalDocAnchors(s,tci->docAnchors);
+    marshalBaseInfoList(s,tci->bases);
+    marshalMembers(s,tci->members);
+    if (tci->templateArguments==0)
+    {
+      marshalUInt(s,NULL_LIST);
+    }
+    else
+    {
+      marshalUInt(s,tci->templateArguments->count());
+      QListIterator<QCString> sli(*tci->templateArguments);
+      QCString *argName;
+      for (;(argName=sli.current());++sli)
+      {
+        marshalQCString(s,*argName);
+      }
+    }
+    marshalStringList(s,tci->classList);
+    marshalInt(s,(int)tci->kind);
+    marshalBool(s,tci->isObjC);
+  }
+
+  marshalUInt(s,m_tagFileFiles.count());
+  QListIterator<TagFileInfo> fit(m_tagFileFiles);
+  TagFileInfo *tfi;
+  for (fit.toFirst();(tfi=fit.current());++fit)
+  {
+    marshalQCString(s,tfi->name);
+    marshalQCString(s,tfi->path);
+    marshalQCString(s,tfi->filename);
+    marshalDocAnchors(s,tfi->docAnchors);
+    marshalMembers(s,tfi->members);
+    marshalStringList(s,tfi->classList);
+    marshalStringList(s,tfi->namespaceList);
+    marshalUInt(s,tfi->includes.count());
+    QListIterator<TagIncludeInfo> iii(tfi->includes);
+    TagIncludeInfo *ii;
+    for (;(ii=iii.current());++iii)
+    {
+      marshalQCString(s,ii->id);
+      marshalQCString(s,ii->name);
+      marshalQCString(s,ii->text);
+      marshalBool(s,ii->isLocal);
+      marshalBool(s,ii->isImported);
+    }
+  }
+
+  marshalUInt(s,m_tagFileNamespaces.count());
+  QListIterator<TagNamespaceInfo> nit(m_tagFileNamespaces);
+  TagNamespaceInfo *tni;
+  for (nit.toFirst();(tni=nit.current());++nit)
+  {
+    marshalQCString(s,tni->name);
+    marshalQCString(s,tni->filename);
+    marshalQCString(s,tni->clangId);
+    marshalStringList(s,tni->classList);
+    marshalStringList(s,tni->namespaceList);
+    marshalDocAnchors(s,tni->docAnchors);
+    marshalMembers(s,tni->members);
+  }
+
+  marshalUInt(s,m_tagFilePackages.count());
+  QListIterator<TagPackageInfo> pit(m_tagFilePackages);
+  TagPackageInfo *tpgi;
+  for (pit.toFirst();(tpgi=pit.current());++pit)
+  {
+    marshalQCString(s,tpgi->name);
+    marshalQCString(s,tpgi->filename);
+    marshalDocAnchors(s,tpgi->docAnchors);
+    marshalMembers(s,tpgi->members);
+    marshalStringList(s,tpgi->classList);
+  }
+
+  marshalUInt(s,m_tagFileGroups.count());
+  QListIterator<TagGroupInfo> git(m_tagFileGroups);
+  TagGroupInfo *tgi;
+  for (git.toFirst();(tgi=git.current());++git)
+  {
+    marshalQCString(s,tgi->name);
+    marshalQCString(s,tgi->title);
+    marshalQCString(s,tgi->filename);
+    marshalDocAnchors(s,tgi->docAnchors);
+    marshalMembers(s,tgi->members);
+    marshalStringList(s,tgi->subgroupList);
+    marshalStringList(s,tgi->classList);
+    marshalStringList(s,tgi->namespaceList);
+    marshalStringList(s,tgi->fileList);
+    marshalStringList(s,tgi->pageList);
+    marshalStringList(s,tgi->dirList);
+  }
+
+  marshalUInt(s,m_tagFilePages.count());
+  QListIterator<TagPageInfo> pgit(m_tagFilePages);
+  TagPageInfo *tpi;
+  for (pgit.toFirst();(tpi=pgit.current());++pgit)
+  {
+    marshalQCString(s,tpi->name);
+    marshalQCString(s,tpi->title);
+    marshalQCString(s,tpi->filename);
+    marshalDocAnchors(s,tpi->docAnchors);
+  }
+
+  marshalUInt(s,m_tagFileDirs.count());
+  QListIterator<TagDirInfo> dit(m_tagFileDirs);
+  TagDirInfo *tdi;
+  for (dit.toFirst();(tdi=dit.current());++dit)
+  {
+    marshalQCString(s,tdi->name);
+    marshalQCString(s,tdi->filename);
+    marshalQCString(s,tdi->path);
+    marshalStringList(s,tdi->subdirList);
+    marshalStringList(s,tdi->fileList);
+    marshalDocAnchors(s,tdi->docAnchors);
+  }
+  f.close();
+
+  QDir dir = QFileInfo(cacheName).dir();
+  QFileInfo cfi(cacheName);
+  if (cfi.exists()) dir.remove(cfi.fileName());
+  if (!dir.rename(QFileInfo(tmpName).fileName(),cfi.fileName()))
+  {
+    dir.remove(QFileInfo(tmpName).fileName());
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/*! Fills the structures of the parser from the tag file cache \a cacheName.
+ *  Returns FALSE if the cache does not exist, is damaged, or was not made 
+ *  from the tag file \a fi with checksum \a checksum.
+ */
+bool TagFileParser::readCache(const QCString &cacheName,const QFileInfo &fi,
+                              uint checksum)
+{
+  QFile f(cacheName);
+  if (!f.exists() || !f.open(IO_ReadOnly)) return FALSE;
+  // the whole cache is read with a single call and decoded from memory
+  uint size = f.size();
+  QByteArray data(size);
+  if (size<8+3*4 || f.readBlock(data.data(),size)!=(int)size) return FALSE;
+  f.close();
+
+  TagCacheBuffer buf(data.data(),size);
+  TagCacheBuffer *s = &buf;
+  char magic[8];
+  s->read(magic,8);
+  if (qstrncmp(magic,TAGCACHE_MAGIC,8)!=0 ||
+      unmarshalUInt(s)!=TAGCACHE_VERSION ||
+      unmarshalUInt(s)!=fi.size() ||
+      unmarshalUInt(s)!=checksum || s->error()
+     )
+  {
+    return FALSE;
+  }
+
+  uint i,j,count;
+  count = s->readCount();
+  for (i=0;i<count && !s->error();i++)
+  {
+    TagClassInfo *tci = new TagClassInfo;
+    tci->name     = s->readString();
+    tci->filename = s->readString();
+    tci->clangId  = s->readString();
+    unmarshalDocAnchors(s,tci->docAnchors);
+    tci->bases    = unmarshalBases(s);
+    unmarshalMembers(s,tci->members);
+    uint numArgs  = s->readCount(TRUE);
+    if (numArgs!=NULL_LIST)
+    {
+      tci->templateArguments = new QList<QCString>;
+      tci->templateArguments->setAutoDelete(TRUE);
+      for (j=0;j<numArgs && !s->error();j++)
+      {
+        tci->templateArguments->append(new QCString(s->readString()));
+      }
+    }
+    unmarshalStringList(s,tci->classList);
+    tci->kind     = (TagClassInfo::Kind)unmarshalInt(s);
+    tci->isObjC   = unmarshalBool(s);
+    m_tagFileClasses.append(tci);
+  }
+
+  count = s->readCount();
+  for (i=0;i<count && !s->error();i++)
+  {
+    TagFileInfo *tfi = new TagFileInfo;
+    tfi->name     = s->readString();
+    tfi->path     = s->readString();
+    tfi->filename = s->readString();
+    unmarshalDocAnchors(s,tfi->docAnchors);
+    unmarshalMembers(s,tfi->members);
+    unmarshalStringList(s,tfi->classList);
+    unmarshalStringList(s,tfi->namespaceList);
+    uint numIncludes = s->readCount();
+    for (j=0;j<numIncludes && !s->error();j++)
+    {
+      TagIncludeInfo *ii = new TagIncludeInfo;
+      ii->id         = s->readString();
+      ii->name       = s->readString();
+      ii->text       = s->readString();
+      ii->isLocal    = unmarshalBool(s);
+      ii->isImported = unmarshalBool(s);
+      tfi->includes.append(ii);
+    }
+    m_tagFileFiles.append(tfi);
+  }
+
+  count = s->readCount();
+  for (i=0;i<count && !s->error();i++)
+  {
+    TagNamespaceInfo *tni = new TagNamespaceInfo;
+    tni->name     = s->readString();
+    tni->filename = s->readString();
+    tni->clangId  = s->readString();
+    unmarshalStringList(s,tni->classList);
+    unmarshalStringList(s,tni->namespaceList);
+    unmarshalDocAnchors(s,tni->docAnchors);
+    unmarshalMembers(s,tni->members);
+    m_tagFileNamespaces.append(tni);
+  }
+
+  count = s->readCount();
+  for (i=0;i<count && !s->error();i++)
+  {
+    TagPackageInfo *tpgi = new TagPackageInfo;
+    tpgi->name     = s->readString();
+    tpgi->filename = s->readString();
+    unmarshalDocAnchors(s,tpgi->docAnchors);
+    unmarshalMembers(s,tpgi->members);
+    unmarshalStringList(s,tpgi->classList);
+    m_tagFilePackages.append(tpgi);
+  }
+
+  count = s->readCount();
+  for (i=0;i<count && !s->error();i++)
+  {
+    TagGroupInfo *tgi = new TagGroupInfo;
+    tgi->name     = s->readString();
+    tgi->title    = s->readString();
+    tgi->filename = s->readString();
+    unmarshalDocAnchors(s,tgi->docAnchors);
+    unmarshalMembers(s,tgi->members);
+    unmarshalStringList(s,tgi->subgroupList);
+    unmarshalStringList(s,tgi->classList);
+    unmarshalStringList(s,tgi->namespaceList);
+    unmarshalStringList(s,tgi->fileList);
+    unmarshalStringList(s,tgi->pageList);
+    unmarshalStringList(s,tgi->dirList);
+    m_tagFileGroups.append(tgi);
+  }
+
+  count = s->readCount();
+  for (i=0;i<count && !s->error();i++)
+  {
+    TagPageInfo *tpi = new TagPageInfo;
+    tpi->name     = s->readString();
+    tpi->title    = s->readString();
+    tpi->filename = s->readString();
+    unmarshalDocAnchors(s,tpi->docAnchors);
+    m_tagFilePages.append(tpi);
+  }
+
+  count = s->readCount();
+  for (i=0;i<count && !s->error();i++)
+  {
+    TagDirInfo *tdi = new TagDirInfo;
+    tdi->name     = s->readString();
+    tdi->filename = s->readString();
+    tdi->path     = s->readString();
+    unmarshalStringList(s,tdi->subdirList);
+    unmarshalStringList(s,tdi->fileList);
+    unmarshalDocAnchors(s,tdi->docAnchors);
+    m_tagFileDirs.append(tdi);
+  }
+
+  if (s->error() || !s->atEnd())
+  {
+    clear();
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/*! Runs the XML parser on the tag file \a fullName, filling the
+ *  structures of \a handler. Returns FALSE if the file could not be parsed.
+ */
+static bool parseTagFileXML(TagFileParser &handler,const char *fullName)
 {
-  QFileInfo fi(fullName);
-  if (!fi.exists()) return;
-  TagFileParser handler( fullName ); // tagName
   handler.setFileName(fullName);
   TagFileErrorHandler errorHandler;
   QFile xmlFile( fullName );
@@ -1536,10 +2084,43 @@ void parseTagFile(Entry *root,const char *fullName)
   QXmlSimpleReader reader;
   reader.setContentHandler( &handler );
   reader.setErrorHandler( &errorHandler );
-  reader.parse( source );
+  return reader.parse( source );
+}
+
+void parseTagFile(Entry *root,const char *fullName)
+{
+  QFileInfo fi(fullName);
+  if (!fi.exists()) return;
+  TagFileParser handler( fullName ); // tagName
+  if (Config_getBool("TAGFILE_CACHE"))
+  {
+    QCString cacheName = tagCacheFileName(fullName);
+    uint checksum = tagFileChecksum(fullName);
+    if (!handler.readCache(cacheName,fi,checksum) &&
+        parseTagFileXML(handler,fullName))
+    {
+      // failing to write the cache, e.g. for a read-only location, is not an error
+      handler.writeCache(cacheName,fi,checksum);
+    }
+  }
+  else
+  {
+    parseTagFileXML(handler,fullName);
+  }
   handler.buildLists(root);
   handler.addIncludes();
   //handler.dump();
 }
 
-
+void writeTagFileCache(const char *fullName)
+{
+  QFileInfo fi(fullName);
+  if (!fi.exists()) return;
+  TagFileParser handler( fullName ); // tagName
+  QCString cacheName = tagCacheFileName(fullName);
+  if (!parseTagFileXML(handler,fullName) || 
+      !handler.writeCache(cacheName,fi,tagFileChecksum(fullName)))
+  {
+    err("cannot write tag file cache %s\n",cacheName.data());
+  }
+}
@@ -26,6 +26,7 @@
 #include <qdir.h>
 #include <qdatetime.h>
 #include <qcache.h>
+#include <qptrdict.h>
 
 #include "util.h"
 #include "message.h"
@@ -52,6 +53,7 @@
 #include "image.h"
 #include "growbuf.h"
 #include "entry.h"
+#include "symboltable.h"
 #include "arguments.h"
 #include "memberlist.h"
 #include "classlist.h"
@@ -146,6 +148,104 @@ void TextGeneratorOLImpl::writeLink(const char *extRef,const char *file,
 // an inheritance tree of depth of 100000 should be enough for everyone :-)
 const int maxInheritanceDepth = 100000; 
 
+//------------------------------------------------------------------------
+// Scanners for the fixed patterns used by the helper functions below.
+// They find the same (leftmost, longest) match as the QRegExp pattern 
+// mentioned in the comment, but scan the string only once and do not 
+// allocate, which matters for the functions that are called for every 
+// type and template argument.
+//------------------------------------------------------------------------
+
+/*! Returns TRUE iff \a c is in [a-z_A-Z\x80-\xFF] */
+static inline bool isIdStartChar(char c)
+{
+  return (c>='a' && c<='z') || (c>='A' && c<='Z') || c=='_' || (uchar)c>=0x80;
+}
+
+/*! Returns TRUE iff \a c is in [a-z_A-Z0-9\x80-\xFF] or in \a extraChars */
+static inline bool isIdChar(char c,const char *extraChars)
+{
+  return isIdStartChar(c) || (c>='0' && c<='9') || 
+         (extraChars && c!=0 && strchr(extraChars,c)!=0);
+}
+
+/*! Finds the first identifier in \a s at or after position \a p.
+ *  Without \a extraChars this is equivalent to matching the regular 
+ *  expression "[a-z_A-Z\x80-\xFF][a-z_A-Z0-9\x80-\xFF]*", the characters 
+ *  in \a extraChars are additionally allowed after the first character.
+ *  Returns the position of the match and its length in \a l, or -1 if 
+ *  there is no match.
+ */
+static int findIdentifier(const QCString &s,int p,int *l,const char *extraChars=0)
+{
+  const char *data = s.data();
+  int sl = s.length();
+  if (p<0) p=0;
+  while (p<sl && !isIdStartChar(data[p])) p++;
+  if (p>=sl) return -1;
+  int e=p+1;
+  while (e<sl && isIdChar(data[e],extraChars)) e++;
+  *l=e-p;
+  return p;
+}
+
+/*! Finds the first word in \a s at or after position \a p.
+ *  Equivalent to matching the regular expression "[a-z_A-Z\x80-\xFF]+".
+ */
+static int findWord(const QCString &s,int p,int *l)
+{
+  const char *data = s.data();
+  int sl = s.length();
+  if (p<0) p=0;
+  while (p<sl && !isIdStartChar(data[p])) p++;
+  if (p>=sl) return -1;
+  int e=p+1;
+  while (e<sl && isIdStartChar(data[e])) e++;
+  *l=e-p;
+  return p;
+}
+
+/*! Finds the first marker (as used for anonymous scopes and by 
+ *  generateMarker()) in \a s at or after position \a p.
+ *  Equivalent to matching the regular expression "@[0-9]+".
+ */
+static int findMarker(const QCString &s,int p,int *l)
+{
+  const char *data = s.data();
+  int sl = s.length();
+  if (p<0) p=0;
+  for (;p<sl-1;p++)
+  {
+    if (data[p]=='@' && data[p+1]>='0' && data[p+1]<='9')
+    {
+      int e=p+2;
+      while (e<sl && data[e]>='0' && data[e]<='9') e++;
+      *l=e-p;
+      return p;
+    }
+  }
+  return -1;
+}
+
+/*! Finds the first anonymous scope in \a s at or after position \a p, 
+ *  including the surrounding scope separators and spaces.
+ *  Equivalent to matching the regular expression "[ :]*@[0-9]+[: ]*".
+ */
+static int findAnonymousScope(const QCString &s,int p,int *l)
+{
+  int ml;
+  int i=findMarker(s,p,&ml);
+  if (i==-1) return -1;
+  const char *data = s.data();
+  int sl = s.length();
+  int b=i;
+  while (b>p && (data[b-1]==' ' || data[b-1]==':')) b--;
+  int e=i+ml;
+  while (e<sl && (data[e]==' ' || data[e]==':')) e++;
+  *l=e-b;
+  return b;
+}
+
 /*! 
   Removes all anonymous scopes from string s
   Possible examples:
@@ -164,10 +264,9 @@ QCString removeAnonymousScopes(const QCString &s)
 {
   QCString result;
   if (s.isEmpty()) return result;
-  static QRegExp re("[ :]*@[0-9]+[: ]*");
   int i,l,sl=s.length();
   int p=0;
-  while ((i=re.match(s,p,&l))!=-1)
+  while ((i=findAnonymousScope(s,p,&l))!=-1)
   {
     result+=s.mid(p,i-p);
     int c=i;
@@ -191,10 +290,9 @@ QCString replaceAnonymousScopes(const QCString &s,const char *replacement)
 {
   QCString result;
   if (s.isEmpty()) return result;
-  static QRegExp re("@[0-9]+");
   int i,l,sl=s.length();
   int p=0;
-  while ((i=re.match(s,p,&l))!=-1)
+  while ((i=findMarker(s,p,&l))!=-1)
   {
     result+=s.mid(p,i-p);
     if (replacement)
@@ -511,7 +609,99 @@ NamespaceDef *getResolvedNamespace(const char *name)
 }
 
 static QDict<MemberDef> g_resolvedTypedefs;
-static QDict<Definition> g_visitedNamespaces;
+// namespaces visited while resolving an explicit scope, keyed on the
+// NamespaceDef pointer so no names need to be hashed during the walk.
+static QPtrDict<Definition> g_visitedNamespaces;
+
+/** @brief Cache for the results of isAccessibleFrom() and
+ *  isAccessibleFromWithExpScope().
+ *
+ *  The key is formed by the scope, file scope and item pointers plus the
+ *  symbol table id of the explicit scope part (-1 if there is none), so no
+ *  string is built, hashed or compared for a lookup.
+ *  The cache is direct mapped: a new result replaces the one in its slot.
+ *  Clearing the cache only bumps a generation counter.
+ */
+class AccessibilityCache
+{
+  public:
+    AccessibilityCache(int size) 
+      : m_generation(1), m_used(0), m_hits(0), m_misses(0)
+    {
+      uint n=1;
+      while (n<(uint)size) n<<=1; // round up to a power of two
+      m_entries = new Entry[n];
+      m_mask = n-1;
+    }
+   ~AccessibilityCache() { delete[] m_entries; }
+    bool find(Definition *scope,FileDef *fileScope,Definition *item,
+              int expScopeId,int &result)
+    {
+      Entry *e = &m_entries[hash(scope,fileScope,item,expScopeId)];
+      if (e->generation==m_generation && e->scope==scope &&
+          e->fileScope==fileScope && e->item==item && e->expScopeId==expScopeId)
+      {
+        m_hits++;
+        result = e->result;
+        return TRUE;
+      }
+      m_misses++;
+      return FALSE;
+    }
+    void insert(Definition *scope,FileDef *fileScope,Definition *item,
+                int expScopeId,int result)
+    {
+      Entry *e = &m_entries[hash(scope,fileScope,item,expScopeId)];
+      if (e->generation!=m_generation) m_used++;
+      e->generation = m_generation;
+      e->scope      = scope;
+      e->fileScope  = fileScope;
+      e->item       = item;
+      e->expScopeId = expScopeId;
+      e->result     = result;
+    }
+    void clear()
+    {
+      if (m_used>0) { m_generation++; m_used=0; }
+    }
+    uint count() const { return m_used; }
+    uint size() const  { return m_mask+1; }
+    int hits() const   { return m_hits; }
+    int misses() const { return m_misses; }
+
+  private:
+    struct Entry
+    {
+      Entry() : generation(0) {}
+      uint generation;
+      Definition *scope;
+      FileDef *fileScope;
+      Definition *item;
+      int expScopeId;
+      int result;
+    };
+    uint hash(Definition *scope,FileDef *fileScope,Definition *item,int expScopeId) const
+    {
+      uint h = (uint)expScopeId;
+      h = (h^(uint)((size_t)scope>>3))*2654435761u;
+      h = (h^(uint)((size_t)fileScope>>3))*2654435761u;
+      h = (h^(uint)((size_t)item>>3))*2654435761u;
+      return (h^(h>>15)) & m_mask;
+    }
+    Entry *m_entries;
+    uint m_mask;
+    uint m_generation;
+    uint m_used;
+    int m_hits;
+    int m_misses;
+};
+
+// only active once the symbol relations have been fully resolved.
+static AccessibilityCache *g_accessibilityCache = 0;
+// number of times the walk was cut short by one of the recursion guards.
+// A result that depends on such a cut depends on the state of the caller
+// and is therefore not cached.
+static int g_accessGuardHits = 0;
 
 // forward declaration
 static ClassDef *getResolvedClassRec(Definition *scope,
@@ -668,53 +858,35 @@ static QCString substTypedef(Definition *scope,FileDef *fileScope,const QCString
   QCString result=name;
   if (name.isEmpty()) return result;
 
-  // lookup scope fragment in the symbol map
-  DefinitionIntf *di = Doxygen::symbolMap->find(name);
-  if (di==0) return result; // no matches
+  // lookup scope fragment in the symbol table
+  int symId = Doxygen::symbolTable->lookup(name);
+  if (symId==-1) return result; // no matches
 
+  // search for the best match
   MemberDef *bestMatch=0;
-  if (di->definitionType()==DefinitionIntf::TypeSymbolList) // multi symbols
+  Definition *d;
+  int i;
+  int minDistance=10000; // init at "infinite"
+  for (i=0;(d=Doxygen::symbolTable->definition(symId,i));i++) // foreach definition
   {
-    // search for the best match
-    DefinitionListIterator dli(*(DefinitionList*)di);
-    Definition *d;
-    int minDistance=10000; // init at "infinite"
-    for (dli.toFirst();(d=dli.current());++dli) // foreach definition
+    // only look at members
+    if (d->definitionType()==Definition::TypeMember)
     {
-      // only look at members
-      if (d->definitionType()==Definition::TypeMember)
+      // that are also typedefs
+      MemberDef *md = (MemberDef *)d;
+      if (md->isTypedef()) // d is a typedef
       {
-        // that are also typedefs
-        MemberDef *md = (MemberDef *)d;
-        if (md->isTypedef()) // d is a typedef
+        // test accessibility of typedef within scope.
+        int distance = isAccessibleFromWithExpScope(scope,fileScope,d,"");
+        if (distance!=-1 && distance<minDistance) 
+          // definition is accessible and a better match
         {
-          // test accessibility of typedef within scope.
-          int distance = isAccessibleFromWithExpScope(scope,fileScope,d,"");
-          if (distance!=-1 && distance<minDistance) 
-            // definition is accessible and a better match
-          {
-            minDistance=distance;
-            bestMatch = md; 
-          }
+          minDistance=distance;
+          bestMatch = md; 
         }
       }
     }
   }
-  else if (di->definitionType()==DefinitionIntf::TypeMember) // single symbol
-  {
-    Definition *d = (Definition*)di;
-    // that are also typedefs
-    MemberDef *md = (MemberDef *)di;
-    if (md->isTypedef()) // d is a typedef
-    {
-      // test accessibility of typedef within scope.
-      int distance = isAccessibleFromWithExpScope(scope,fileScope,d,"");
-      if (distance!=-1) // definition is accessible 
-      {
-        bestMatch = md; 
-      }
-    }
-  }
   if (bestMatch) 
   {
     result = bestMatch->typeString();
@@ -748,19 +920,48 @@ static Definition *endOfPathIsUsedClass(SDict<Definition> *cl,const QCString &lo
  *  searched. If found the scope definition is returned, otherwise 0 
  *  is returned.
  */
-static Definition *followPath(Definition *start,FileDef *fileScope,const QCString &path)
+/*! Returns the id of the explicit scope \a path in Doxygen::symbolTable,
+ *  or -1 if \a path is empty. The parts of the path are interned as well
+ *  and stored as the scope chain of the path the first time it is seen.
+ */
+static int explicitScopeId(const QCString &path)
 {
-  int is,ps;
-  int l;
+  if (path.isEmpty()) return -1;
+  SymbolTable *symTab = Doxygen::symbolTable;
+  int id = symTab->intern(path);
+  if (!symTab->hasScopeChain(id))
+  {
+    int is,ps=0,l,count=0;
+    while ((is=getScopeFragment(path,ps,&l))!=-1) { count++; ps=is+l; }
+    QArray<int> parts(count);
+    ps=0; count=0;
+    while ((is=getScopeFragment(path,ps,&l))!=-1)
+    {
+      parts[count++] = symTab->intern(path.mid(is,l));
+      ps=is+l;
+    }
+    symTab->setScopeChain(id,parts.data(),count);
+  }
+  return id;
+}
+
+/*! Follows the scope chain of the explicit scope with id \a pathId,
+ *  starting at \a start. Returns the definition at the end of the path,
+ *  or 0 if the path could not be followed.
+ */
+static Definition *followPath(Definition *start,FileDef *fileScope,int pathId)
+{
+  SymbolTable *symTab = Doxygen::symbolTable;
   Definition *current=start;
-  ps=0;
-  //printf("followPath: start='%s' path='%s'\n",start?start->name().data():"<none>",path.data());
+  int i,n = symTab->scopeChainLength(pathId);
+  //printf("followPath: start='%s' path='%s'\n",start?start->name().data():"<none>",symTab->name(pathId));
   // for each part of the explicit scope
-  while ((is=getScopeFragment(path,ps,&l))!=-1)
+  for (i=0;i<n;i++)
   {
+    QCString part = symTab->name(symTab->scopeChainPart(pathId,i));
     // try to resolve the part if it is a typedef
     MemberDef *typeDef=0;
-    QCString qualScopePart = substTypedef(current,fileScope,path.mid(is,l),&typeDef);
+    QCString qualScopePart = substTypedef(current,fileScope,part,&typeDef);
     //printf("      qualScopePart=%s\n",qualScopePart.data());
     if (typeDef)
     {
@@ -797,17 +998,16 @@ static Definition *followPath(Definition *start,FileDef *fileScope,const QCStrin
       current = next;
       //printf("==> current = %p\n",current);
     }
-    ps=is+l;
   }
   //printf("followPath(start=%s,path=%s) result=%s\n",
-  //    start->name().data(),path.data(),current?current->name().data():"<null>");
+  //    start->name().data(),symTab->name(pathId),current?current->name().data():"<null>");
   return current; // path could be followed
 }
 
 bool accessibleViaUsingClass(const SDict<Definition> *cl,
                              FileDef *fileScope,
                              Definition *item,
-                             const QCString &explicitScopePart=""
+                             int expScopeId=-1
                             )
 {
   //printf("accessibleViaUsingClass(%p)\n",cl);
@@ -815,11 +1015,10 @@ bool accessibleViaUsingClass(const SDict<Definition> *cl,
   {
     SDict<Definition>::Iterator cli(*cl);
     Definition *ucd;
-    bool explicitScopePartEmpty = explicitScopePart.isEmpty();
     for (cli.toFirst();(ucd=cli.current());++cli)
     {
       //printf("Trying via used class %s\n",ucd->name().data());
-      Definition *sc = explicitScopePartEmpty ? ucd : followPath(ucd,fileScope,explicitScopePart);
+      Definition *sc = expScopeId==-1 ? ucd : followPath(ucd,fileScope,expScopeId);
       if (sc && sc==item) return TRUE; 
       //printf("Try via used class done\n");
     }
@@ -830,9 +1029,9 @@ bool accessibleViaUsingClass(const SDict<Definition> *cl,
 bool accessibleViaUsingNamespace(const NamespaceSDict *nl,
                                  FileDef *fileScope,
                                  Definition *item,
-                                 const QCString &explicitScopePart="")
+                                 int expScopeId=-1)
 {
-  static QDict<void> visitedDict;
+  static QPtrDict<void> visitedDict;
   if (nl) // check used namespaces for the class
   {
     NamespaceSDict::Iterator nli(*nl);
@@ -842,24 +1041,27 @@ bool accessibleViaUsingNamespace(const NamespaceSDict *nl,
     {
       //printf("[Trying via used namespace %s: count=%d/%d\n",und->name().data(),
       //    count,nl->count());
-      Definition *sc = explicitScopePart.isEmpty() ? und : followPath(und,fileScope,explicitScopePart);
+      Definition *sc = expScopeId==-1 ? und : followPath(und,fileScope,expScopeId);
       if (sc && item->getOuterScope()==sc) 
       {
         //printf("] found it\n");
         return TRUE; 
       }
-      QCString key=und->name();
-      if (und->getUsedNamespaces() && visitedDict.find(key)==0)
+      if (und->getUsedNamespaces() && visitedDict.find(und)!=0)
       {
-        visitedDict.insert(key,(void *)0x08);
+        g_accessGuardHits++; // already being searched higher up
+      }
+      else if (und->getUsedNamespaces())
+      {
+        visitedDict.insert(und,(void *)0x08);
 
-        if (accessibleViaUsingNamespace(und->getUsedNamespaces(),fileScope,item,explicitScopePart))
+        if (accessibleViaUsingNamespace(und->getUsedNamespaces(),fileScope,item,expScopeId))
         {
           //printf("] found it via recursion\n");
           return TRUE;
         }
 
-        visitedDict.remove(key);
+        visitedDict.remove(und);
       }
       //printf("] Try via used namespace done\n");
     }
@@ -886,14 +1088,14 @@ class AccessStack
         m_index++;
       }
     }
-    void push(Definition *scope,FileDef *fileScope,Definition *item,const QCString &expScope)
+    void push(Definition *scope,FileDef *fileScope,Definition *item,int expScopeId)
     {
       if (m_index<MAX_STACK_SIZE)
       {
-        m_elements[m_index].scope     = scope;
-        m_elements[m_index].fileScope = fileScope;
-        m_elements[m_index].item      = item;
-        m_elements[m_index].expScope  = expScope;
+        m_elements[m_index].scope      = scope;
+        m_elements[m_index].fileScope  = fileScope;
+        m_elements[m_index].item       = item;
+        m_elements[m_index].expScopeId = expScopeId;
         m_index++;
       }
     }
@@ -914,13 +1116,13 @@ class AccessStack
       }
       return FALSE;
     }
-    bool find(Definition *scope,FileDef *fileScope, Definition *item,const QCString &expScope)
+    bool find(Definition *scope,FileDef *fileScope, Definition *item,int expScopeId)
     {
       int i=0;
       for (i=0;i<m_index;i++)
       {
         AccessElem *e = &m_elements[i];
-        if (e->scope==scope && e->fileScope==fileScope && e->item==item && e->expScope==expScope) 
+        if (e->scope==scope && e->fileScope==fileScope && e->item==item && e->expScopeId==expScopeId) 
         {
           return TRUE;
         }
@@ -935,12 +1137,38 @@ class AccessStack
       Definition *scope;
       FileDef *fileScope;
       Definition *item;
-      QCString expScope;
+      int expScopeId;
     };
     int m_index;
     AccessElem m_elements[MAX_STACK_SIZE];
 };
 
+void initAccessibilityCache(int size)
+{
+  delete g_accessibilityCache;
+  g_accessibilityCache = new AccessibilityCache(size);
+}
+
+void clearAccessibilityCache()
+{
+  if (g_accessibilityCache)
+  {
+    g_accessibilityCache->clear();
+  }
+}
+
+void printAccessibilityCacheStats()
+{
+  if (g_accessibilityCache)
+  {
+    msg("accessibility cache used %d/%d hits=%d misses=%d\n",
+        g_accessibilityCache->count(),
+        g_accessibilityCache->size(),
+        g_accessibilityCache->hits(),
+        g_accessibilityCache->misses());
+  }
+}
+
 /* Returns the "distance" (=number of levels up) from item to scope, or -1
  * if item in not inside scope. 
  */
@@ -952,8 +1180,16 @@ int isAccessibleFrom(Definition *scope,FileDef *fileScope,Definition *item)
   static AccessStack accessStack;
   if (accessStack.find(scope,fileScope,item))
   {
+    g_accessGuardHits++;
     return -1;
   }
+  int cachedResult;
+  if (g_accessibilityCache && 
+      g_accessibilityCache->find(scope,fileScope,item,-1,cachedResult))
+  {
+    return cachedResult;
+  }
+  int guardHits = g_accessGuardHits;
   accessStack.push(scope,fileScope,item);
 
   int result=0; // assume we found it
@@ -1027,7 +1263,10 @@ int isAccessibleFrom(Definition *scope,FileDef *fileScope,Definition *item)
   }
 done:
   accessStack.pop();
-  //Doxygen::lookupCache.insert(key,new int(result));
+  if (g_accessibilityCache && guardHits==g_accessGuardHits)
+  {
+    g_accessibilityCache->insert(scope,fileScope,item,-1,result);
+  }
   return result;
 }
 
@@ -1046,29 +1285,40 @@ done:
  * - Looking for item=='A::I' inside scope=='B', first the match B::A::I is tried but 
  *   not found and then A::I is searched in the global scope, which matches and 
  *   thus the result is 1.
+ *
+ * The explicit scope is passed as its id in Doxygen::symbolTable, see 
+ * explicitScopeId(), so the walk only compares ids.
  */
-int isAccessibleFromWithExpScope(Definition *scope,FileDef *fileScope,
-                     Definition *item,const QCString &explicitScopePart)
+static int isAccessibleFromWithExpScopeId(Definition *scope,FileDef *fileScope,
+                     Definition *item,int expScopeId)
 {
-  if (explicitScopePart.isEmpty())
+  if (expScopeId==-1)
   {
     // handle degenerate case where there is no explicit scope.
     return isAccessibleFrom(scope,fileScope,item);
   }
 
   static AccessStack accessStack;
-  if (accessStack.find(scope,fileScope,item,explicitScopePart))
+  if (accessStack.find(scope,fileScope,item,expScopeId))
   {
+    g_accessGuardHits++;
     return -1;
   }
-  accessStack.push(scope,fileScope,item,explicitScopePart);
+  int cachedResult;
+  if (g_accessibilityCache && 
+      g_accessibilityCache->find(scope,fileScope,item,expScopeId,cachedResult))
+  {
+    return cachedResult;
+  }
+  int guardHits = g_accessGuardHits;
+  accessStack.push(scope,fileScope,item,expScopeId);
 
 
   //printf("  <isAccessibleFromWithExpScope(%s,%s,%s)\n",scope?scope->name().data():"<global>",
   //                                      item?item->name().data():"<none>",
-  //                                      explicitScopePart.data());
+  //                                      Doxygen::symbolTable->name(expScopeId));
   int result=0; // assume we found it
-  Definition *newScope = followPath(scope,fileScope,explicitScopePart);
+  Definition *newScope = followPath(scope,fileScope,expScopeId);
   if (newScope)  // explicitScope is inside scope => newScope is the result
   {
     Definition *itemScope = item->getOuterScope();
@@ -1105,7 +1355,7 @@ int isAccessibleFromWithExpScope(Definition *scope,FileDef *fileScope,
       int i=-1;
       if (newScope->definitionType()==Definition::TypeNamespace)
       {
-        g_visitedNamespaces.insert(newScope->name(),newScope);
+        g_visitedNamespaces.insert(newScope,newScope);
         // this part deals with the case where item is a class
         // A::B::C but is explicit referenced as A::C, where B is imported
         // in A via a using directive.
@@ -1133,10 +1383,15 @@ int isAccessibleFromWithExpScope(Definition *scope,FileDef *fileScope,
           NamespaceDef *nd;
           for (nli.toFirst();(nd=nli.current());++nli)
           {
-            if (g_visitedNamespaces.find(nd->name())==0)
+            if (g_visitedNamespaces.find(nd)!=0)
+            {
+              g_accessGuardHits++; // result depends on the namespaces visited so far
+            }
+            else
             {
               //printf("Trying for namespace %s\n",nd->name().data());
-              i = isAccessibleFromWithExpScope(scope,fileScope,item,nd->name());
+              i = isAccessibleFromWithExpScopeId(scope,fileScope,item,
+                                                 explicitScopeId(nd->name()));
               if (i!=-1)
               {
                 //printf("> found via explicit scope of used namespace\n");
@@ -1149,8 +1404,8 @@ int isAccessibleFromWithExpScope(Definition *scope,FileDef *fileScope,
       // repeat for the parent scope
       if (scope!=Doxygen::globalScope)
       {
-        i = isAccessibleFromWithExpScope(scope->getOuterScope(),fileScope,
-            item,explicitScopePart);
+        i = isAccessibleFromWithExpScopeId(scope->getOuterScope(),fileScope,
+            item,expScopeId);
       }
       //printf("  | result=%d\n",i);
       result = (i==-1) ? -1 : i+2;
@@ -1163,7 +1418,7 @@ int isAccessibleFromWithExpScope(Definition *scope,FileDef *fileScope,
     {
       NamespaceDef *nscope = (NamespaceDef*)scope;
       NamespaceSDict *nl = nscope->getUsedNamespaces();
-      if (accessibleViaUsingNamespace(nl,fileScope,item,explicitScopePart)) 
+      if (accessibleViaUsingNamespace(nl,fileScope,item,expScopeId)) 
       {
         //printf("> found in used namespace\n");
         goto done;
@@ -1174,7 +1429,7 @@ int isAccessibleFromWithExpScope(Definition *scope,FileDef *fileScope,
       if (fileScope)
       {
         NamespaceSDict *nl = fileScope->getUsedNamespaces();
-        if (accessibleViaUsingNamespace(nl,fileScope,item,explicitScopePart)) 
+        if (accessibleViaUsingNamespace(nl,fileScope,item,expScopeId)) 
         {
           //printf("> found in used namespace\n");
           goto done;
@@ -1185,8 +1440,8 @@ int isAccessibleFromWithExpScope(Definition *scope,FileDef *fileScope,
     }
     else // continue by looking into the parent scope
     {
-      int i=isAccessibleFromWithExpScope(scope->getOuterScope(),fileScope,
-          item,explicitScopePart);
+      int i=isAccessibleFromWithExpScopeId(scope->getOuterScope(),fileScope,
+          item,expScopeId);
       //printf("> result=%d\n",i);
       result= (i==-1) ? -1 : i+2;
     }
@@ -1195,10 +1450,20 @@ int isAccessibleFromWithExpScope(Definition *scope,FileDef *fileScope,
 done:
   //printf("  > result=%d\n",result);
   accessStack.pop();
-  //Doxygen::lookupCache.insert(key,new int(result));
+  if (g_accessibilityCache && guardHits==g_accessGuardHits)
+  {
+    g_accessibilityCache->insert(scope,fileScope,item,expScopeId,result);
+  }
   return result;
 }
 
+int isAccessibleFromWithExpScope(Definition *scope,FileDef *fileScope,
+                     Definition *item,const QCString &explicitScopePart)
+{
+  return isAccessibleFromWithExpScopeId(scope,fileScope,item,
+                                        explicitScopeId(explicitScopePart));
+}
+
 int computeQualifiedIndex(const QCString &name)
 {
   int i = name.find('<');
@@ -1208,7 +1473,7 @@ int computeQualifiedIndex(const QCString &name)
 static void getResolvedSymbol(Definition *scope,
                        FileDef *fileScope,
                        Definition *d, 
-                       const QCString &explicitScopePart,
+                       int expScopeId,
                        ArgumentList *actTemplParams,
                        int &minDistance,
                        ClassDef *&bestMatch,
@@ -1229,7 +1494,7 @@ static void getResolvedSymbol(Definition *scope,
   {
     g_visitedNamespaces.clear();
     // test accessibility of definition within scope.
-    int distance = isAccessibleFromWithExpScope(scope,fileScope,d,explicitScopePart);
+    int distance = isAccessibleFromWithExpScopeId(scope,fileScope,d,expScopeId);
     //printf("  %s; distance %s (%p) is %d\n",scope->name().data(),d->name().data(),d,distance);
     if (distance!=-1) // definition is accessible
     {
@@ -1409,16 +1674,16 @@ static ClassDef *getResolvedClassRec(Definition *scope,
   }
 
   //printf("Looking for symbol %s\n",name.data());
-  DefinitionIntf *di = Doxygen::symbolMap->find(name);
+  int symId = Doxygen::symbolTable->lookup(name);
   // the -g (for C# generics) and -p (for ObjC protocols) are now already 
   // stripped from the key used in the symbolMap, so that is not needed here.
-  if (di==0) 
+  if (symId==-1) 
   {
-    //di = Doxygen::symbolMap->find(name+"-g");
-    //if (di==0)
+    //symId = Doxygen::symbolTable->lookup(name+"-g");
+    //if (symId==-1)
     //{
-      di = Doxygen::symbolMap->find(name+"-p");
-      if (di==0)
+      symId = Doxygen::symbolTable->lookup(name+"-p");
+      if (symId==-1)
       {
         //printf("no such symbol!\n");
         return 0;
@@ -1498,24 +1763,14 @@ static ClassDef *getResolvedClassRec(Definition *scope,
   QCString bestResolvedType;
   int minDistance=10000; // init at "infinite"
 
-  if (di->definitionType()==DefinitionIntf::TypeSymbolList) // not a unique name
-  {
-    //printf("  name is not unique\n");
-    DefinitionListIterator dli(*(DefinitionList*)di);
-    Definition *d;
-    int count=0;
-    for (dli.toFirst();(d=dli.current());++dli,++count) // foreach definition
-    {
-      getResolvedSymbol(scope,fileScope,d,explicitScopePart,&actTemplParams,
-                        minDistance,bestMatch,bestTypedef,bestTemplSpec,
-                        bestResolvedType);
-    }
-  }
-  else // unique name
+  // getResolvedSymbol() can add symbols (template instances) with the
+  // same name, so walk the definitions by index.
+  Definition *d;
+  int i;
+  int expScopeId = explicitScopeId(explicitScopePart);
+  for (i=0;(d=Doxygen::symbolTable->definition(symId,i));i++) // foreach definition
   {
-    //printf("  name is unique\n");
-    Definition *d = (Definition *)di;
-    getResolvedSymbol(scope,fileScope,d,explicitScopePart,&actTemplParams,
+    getResolvedSymbol(scope,fileScope,d,expScopeId,&actTemplParams,
                       minDistance,bestMatch,bestTypedef,bestTemplSpec,
                       bestResolvedType);
   }
@@ -1918,7 +2173,7 @@ void linkifyText(const TextGeneratorIntf &out,Definition *scope,
     bool keepSpaces,int indentLevel)
 {
   //printf("linkify=`%s'\n",text);
-  static QRegExp regExp("[a-z_A-Z\\x80-\\xFF][~!a-z_A-Z0-9$\\\\.:\\x80-\\xFF]*");
+  // identifiers are matched as [a-z_A-Z\x80-\xFF][~!a-z_A-Z0-9$\\.:\x80-\xFF]*
   static QRegExp regExpSplit("(?!:),");
   QCString txtStr=text;
   int strLen = txtStr.length();
@@ -1933,7 +2188,7 @@ void linkifyText(const TextGeneratorIntf &out,Definition *scope,
   int floatingIndex=0;
   if (strLen==0) return;
   // read a word from the text string
-  while ((newIndex=regExp.match(txtStr,index,&matchLen))!=-1 && 
+  while ((newIndex=findIdentifier(txtStr,index,&matchLen,"~!$\\.:"))!=-1 && 
       (newIndex==0 || !(txtStr.at(newIndex-1)>='0' && txtStr.at(newIndex-1)<='9')) // avoid matching part of hex numbers
       )
   {
@@ -2109,10 +2364,9 @@ void writeExample(OutputList &ol,ExampleSDict *ed)
   //bool latexEnabled = ol.isEnabled(OutputGenerator::Latex);
   //bool manEnabled   = ol.isEnabled(OutputGenerator::Man);
   //bool htmlEnabled  = ol.isEnabled(OutputGenerator::Html);
-  QRegExp marker("@[0-9]+");
   int index=0,newIndex,matchLen;
   // now replace all markers in inheritLine with links to the classes
-  while ((newIndex=marker.match(exampleLine,index,&matchLen))!=-1)
+  while ((newIndex=findMarker(exampleLine,index,&matchLen))!=-1)
   {
     bool ok;
     ol.parseText(exampleLine.mid(index,newIndex-index));
@@ -3504,11 +3758,10 @@ static QCString extractCanonicalType(Definition *d,FileDef *fs,QCString type)
                               // (i.e. type is not a template specialization)
                               // then resolve any identifiers inside. 
     {
-      static QRegExp re("[a-z_A-Z\\x80-\\xFF][a-z_A-Z0-9\\x80-\\xFF]*");
       int tp=0,tl,ti;
       // for each identifier template specifier
       //printf("adding resolved %s to %s\n",templSpec.data(),canType.data());
-      while ((ti=re.match(templSpec,tp,&tl))!=-1)
+      while ((ti=findIdentifier(templSpec,tp,&tl))!=-1)
       {
         canType += templSpec.mid(tp,ti-tp);
         canType += getCanonicalTypeForIdentifier(d,fs,templSpec.mid(ti,tl),0);
@@ -3826,6 +4079,81 @@ void mergeArguments(ArgumentList *srcAl,ArgumentList *dstAl,bool forceNameOverwr
   }
 }
 
+/*! Returns the argument list that results from parsing \a args, as
+ *  used for matching against members found in file scope \a fd. The
+ *  list is created on first use and stored in \a cache, so the
+ *  canonical types of its arguments (which are computed lazily by
+ *  matchArguments2()) are only resolved once per file scope, instead of
+ *  once for every overload that is tried.
+ */
+static ArgumentList *argumentListForFileScope(QPtrDict<ArgumentList> &cache,
+                                              ArgumentList *&noFileScopeAl,
+                                              FileDef *fd,const char *args)
+{
+  ArgumentList *al = fd ? cache.find(fd) : noFileScopeAl;
+  if (al==0)
+  {
+    al = new ArgumentList;
+    stringToArgumentList(args,al);
+    if (fd) cache.insert(fd,al); else noFileScopeAl=al;
+  }
+  return al;
+}
+
+/*! Fills \a dist with the inheritance distance from class \a cd to 
+ *  itself and to each of its direct and indirect base classes. 
+ *  The distances are the same as those returned by minClassDistance(), 
+ *  but this allows testing many candidate classes with a single lookup 
+ *  each, instead of walking the inheritance hierarchy per candidate.
+ */
+static void computeBaseClassDistances(ClassDef *cd,QPtrDict<int> &dist)
+{
+  dist.setAutoDelete(TRUE);
+  dist.insert(cd,new int(0));
+  QList<ClassDef> level,next;
+  level.append(cd);
+  int d=0;
+  while (!level.isEmpty() && d<maxInheritanceDepth)
+  {
+    d++;
+    QListIterator<ClassDef> li(level);
+    ClassDef *lcd;
+    for (;(lcd=li.current());++li)
+    {
+      if (lcd->baseClasses())
+      {
+        BaseClassListIterator bcli(*lcd->baseClasses());
+        BaseClassDef *bcdi;
+        for (;(bcdi=bcli.current());++bcli)
+        {
+          if (dist.find(bcdi->classDef)==0) // first (=shortest) path to this base
+          {
+            dist.insert(bcdi->classDef,new int(d));
+            next.append(bcdi->classDef);
+          }
+        }
+      }
+    }
+    level=next;
+    next.clear();
+  }
+}
+
+/*! Returns the distance of \a bcd in the inheritance distance table \a dist
+ *  computed by computeBaseClassDistances(), or maxInheritanceDepth if
+ *  \a bcd is not a base class.
+ */
+static int lookupClassDistance(QPtrDict<int> &dist,ClassDef *bcd)
+{
+  if (bcd->categoryOf()) // use class that is being extended in case of 
+    // an Objective-C category
+  {
+    bcd=bcd->categoryOf();
+  }
+  int *pd = dist.find(bcd);
+  return pd ? *pd : maxInheritanceDepth;
+}
+
 static void findMembersWithSpecificName(MemberName *mn,
                                         const char *args,
                                         bool checkStatics,
@@ -3836,6 +4164,9 @@ static void findMembersWithSpecificName(MemberName *mn,
 {
   //printf("  Function with global scope name `%s' args=`%s'\n",
   //       mn->memberName(),args);
+  QPtrDict<ArgumentList> argListCache;
+  argListCache.setAutoDelete(TRUE);
+  ArgumentList *noFileScopeAl=0;
   MemberListIterator mli(*mn);
   MemberDef *md;
   for (mli.toFirst();(md=mli.current());++mli)
@@ -3852,17 +4183,14 @@ static void findMembersWithSpecificName(MemberName *mn,
        ) 
     {
       bool match=TRUE;
-      ArgumentList *argList=0;
       if (args && !md->isDefine() && qstrcmp(args,"()")!=0)
       {
-        argList=new ArgumentList;
         ArgumentList *mdAl = md->argumentList();
-        stringToArgumentList(args,argList);
+        ArgumentList *argList = argumentListForFileScope(argListCache,noFileScopeAl,fd,args);
         match=matchArguments2(
             md->getOuterScope(),fd,mdAl,
             Doxygen::globalScope,fd,argList,
             checkCV); 
-        delete argList; argList=0;
       }
       if (match && (forceTagFile==0 || md->getReference()==forceTagFile)) 
       {
@@ -3871,6 +4199,7 @@ static void findMembersWithSpecificName(MemberName *mn,
       }
     }
   }
+  delete noFileScopeAl;
 }
 
 /*!
@@ -3987,29 +4316,31 @@ bool getDefs(const QCString &scName,
           argList=new ArgumentList;
           stringToArgumentList(args,argList);
         }
+        // only members of fcd or one of its base classes can match, so 
+        // determine those first and avoid matching the arguments of 
+        // overloads found in unrelated classes.
+        QPtrDict<int> baseDist(257);
+        computeBaseClassDistances(fcd,baseDist);
         for (mmli.toFirst();(mmd=mmli.current());++mmli)
         {
-          if (!mmd->isStrongEnumValue())
+          ClassDef *mcd=mmd->getClassDef();
+          if (mcd && !mmd->isStrongEnumValue())
           {
-            ArgumentList *mmdAl = mmd->argumentList();
-            bool match=args==0 || 
-              matchArguments2(mmd->getOuterScope(),mmd->getFileDef(),mmdAl,
-                  fcd,fcd->getFileDef(),argList,
-                  checkCV
-                  );  
-            //printf("match=%d\n",match);
-            if (match)
+            int m=lookupClassDistance(baseDist,mcd);
+            if (m<mdist && mcd->isLinkable())
             {
-              ClassDef *mcd=mmd->getClassDef();
-              if (mcd)
+              ArgumentList *mmdAl = mmd->argumentList();
+              bool match=args==0 || 
+                matchArguments2(mmd->getOuterScope(),mmd->getFileDef(),mmdAl,
+                    fcd,fcd->getFileDef(),argList,
+                    checkCV
+                    );  
+              //printf("match=%d\n",match);
+              if (match)
               {
-                int m=minClassDistance(fcd,mcd);
-                if (m<mdist && mcd->isLinkable())
-                {
-                  mdist=m;
-                  cd=mcd;
-                  md=mmd;
-                }
+                mdist=m;
+                cd=mcd;
+                md=mmd;
               }
             }
           }
@@ -4030,7 +4361,7 @@ bool getDefs(const QCString &scName,
             //printf("  >Class %s found\n",mcd->name().data());
             if (mcd)
             {
-              int m=minClassDistance(fcd,mcd);
+              int m=lookupClassDistance(baseDist,mcd);
               if (m<mdist /* && mcd->isLinkable()*/ )
               {
                 //printf("Class distance %d\n",m);
@@ -4170,6 +4501,9 @@ bool getDefs(const QCString &scName,
         //printf("Symbol inside existing namespace `%s' count=%d\n",
         //    namespaceName.data(),mn->count());
         bool found=FALSE;
+        QPtrDict<ArgumentList> argListCache;
+        argListCache.setAutoDelete(TRUE);
+        ArgumentList *noFileScopeAl=0;
         MemberListIterator mmli(*mn);
         MemberDef *mmd;
         for (mmli.toFirst();((mmd=mmli.current()) && !found);++mmli)
@@ -4190,6 +4524,7 @@ bool getDefs(const QCString &scName,
             }
             else
             {
+              delete noFileScopeAl;
               md=0;
               cd=0;
               return FALSE;
@@ -4198,12 +4533,11 @@ bool getDefs(const QCString &scName,
           else if (mmd->getNamespaceDef()==fnd /* && mmd->isLinkable() */ )
           { // namespace is found
             bool match=TRUE;
-            ArgumentList *argList=0;
             if (args && qstrcmp(args,"()")!=0)
             {
-              argList=new ArgumentList;
               ArgumentList *mmdAl = mmd->argumentList();
-              stringToArgumentList(args,argList);
+              ArgumentList *argList = argumentListForFileScope(
+                  argListCache,noFileScopeAl,mmd->getFileDef(),args);
               match=matchArguments2(
                   mmd->getOuterScope(),mmd->getFileDef(),mmdAl,
                   fnd,mmd->getFileDef(),argList,
@@ -4215,12 +4549,9 @@ bool getDefs(const QCString &scName,
               md=mmd;
               found=TRUE;
             }
-            if (args)
-            {
-              delete argList; argList=0;
-            }
           }
         }
+        delete noFileScopeAl;
         if (!found && args && !qstrcmp(args,"()")) 
           // no exact match found, but if args="()" an arbitrary 
           // member will do
@@ -5880,9 +6211,11 @@ void addMembersToMemberGroup(MemberList *ml,
  */
 int extractClassNameFromType(const QCString &type,int &pos,QCString &name,QCString &templSpec,SrcLangExt lang)
 {
-  static const QRegExp re_norm("[a-z_A-Z\\x80-\\xFF][a-z_A-Z0-9:\\x80-\\xFF]*");
-  static const QRegExp re_ftn("[a-z_A-Z\\x80-\\xFF][()=_a-z_A-Z0-9:\\x80-\\xFF]*");
-  QRegExp re;
+  // class names are matched as [a-z_A-Z\x80-\xFF][a-z_A-Z0-9:\x80-\xFF]*,
+  // or for Fortran as [a-z_A-Z\x80-\xFF][()=_a-z_A-Z0-9:\x80-\xFF]*
+  static const char *extraCharsNorm = ":";
+  static const char *extraCharsFtn  = "()=:";
+  const char *extraChars;
 
   name.resize(0);
   templSpec.resize(0);
@@ -5895,19 +6228,19 @@ int extractClassNameFromType(const QCString &type,int &pos,QCString &name,QCStri
       if (type.at(pos)==',') return -1;
       if (type.left(4).lower()=="type")
       {
-        re = re_norm;
+        extraChars = extraCharsNorm;
       }
       else
       {
-        re = re_ftn;
+        extraChars = extraCharsFtn;
       }
     }
     else
     {
-      re = re_norm;
+      extraChars = extraCharsNorm;
     }
 
-    if ((i=re.match(type,pos,&l))!=-1) // for each class name in the type
+    if ((i=findIdentifier(type,pos,&l,extraChars))!=-1) // for each class name in the type
     {
       int ts=i+l;
       int te=ts;
@@ -5963,10 +6296,9 @@ QCString normalizeNonTemplateArgumentsInString(
   p++;
   QCString result = name.left(p);
 
-  static QRegExp re("[a-z_A-Z\\x80-\\xFF][a-z_A-Z0-9\\x80-\\xFF]*");
   int l,i;
   // for each identifier in the template part (e.g. B<T> -> T)
-  while ((i=re.match(name,p,&l))!=-1)
+  while ((i=findIdentifier(name,p,&l))!=-1)
   {
     result += name.mid(p,i-p);
     QCString n = name.mid(i,l);
@@ -6023,10 +6355,9 @@ QCString substituteTemplateArgumentsInString(
   //    name.data(),argListToString(formalArgs).data(),argListToString(actualArgs).data());
   if (formalArgs==0) return name;
   QCString result;
-  static QRegExp re("[a-z_A-Z\\x80-\\xFF][a-z_A-Z0-9\\x80-\\xFF]*");
   int p=0,l,i;
   // for each identifier in the base class name (e.g. B<T> -> B and T)
-  while ((i=re.match(name,p,&l))!=-1)
+  while ((i=findIdentifier(name,p,&l))!=-1)
   {
     result += name.mid(p,i-p);
     QCString n = name.mid(i,l);
@@ -6657,9 +6988,8 @@ QCString stripPath(const char *s)
 /** returns \c TRUE iff string \a s contains word \a w */
 bool containsWord(const QCString &s,const QCString &word)
 {
-  static QRegExp wordExp("[a-z_A-Z\\x80-\\xFF]+");
   int p=0,i,l;
-  while ((i=wordExp.match(s,p,&l))!=-1)
+  while ((i=findWord(s,p,&l))!=-1)
   {
     if (s.mid(i,l)==word) return TRUE;
     p=i+l;
@@ -6669,9 +6999,8 @@ bool containsWord(const QCString &s,const QCString &word)
 
 bool findAndRemoveWord(QCString &s,const QCString &word)
 {
-  static QRegExp wordExp("[a-z_A-Z\\x80-\\xFF]+");
   int p=0,i,l;
-  while ((i=wordExp.match(s,p,&l))!=-1)
+  while ((i=findWord(s,p,&l))!=-1)
   {
     if (s.mid(i,l)==word) 
     {
@@ -6913,8 +7242,8 @@ MemberDef *getMemberFromSymbol(Definition *scope,FileDef *fileScope,
   if (name.isEmpty())
     return 0; // no name was given
 
-  DefinitionIntf *di = Doxygen::symbolMap->find(name);
-  if (di==0)
+  int symId = Doxygen::symbolTable->lookup(name);
+  if (symId==-1)
     return 0; // could not find any matching symbols
 
   // mostly copied from getResolvedClassRec()
@@ -6931,40 +7260,24 @@ MemberDef *getMemberFromSymbol(Definition *scope,FileDef *fileScope,
   int minDistance = 10000;
   MemberDef *bestMatch = 0;
 
-  if (di->definitionType()==DefinitionIntf::TypeSymbolList)
+  // find the closest closest matching definition
+  Definition *d;
+  int i;
+  int expScopeId = explicitScopeId(explicitScopePart);
+  for (i=0;(d=Doxygen::symbolTable->definition(symId,i));i++)
   {
-    //printf("multiple matches!\n");
-    // find the closest closest matching definition
-    DefinitionListIterator dli(*(DefinitionList*)di);
-    Definition *d;
-    for (dli.toFirst();(d=dli.current());++dli)
+    if (d->definitionType()==Definition::TypeMember)
     {
-      if (d->definitionType()==Definition::TypeMember)
+      g_visitedNamespaces.clear();
+      int distance = isAccessibleFromWithExpScopeId(scope,fileScope,d,expScopeId);
+      if (distance!=-1 && distance<minDistance)
       {
-        g_visitedNamespaces.clear();
-        int distance = isAccessibleFromWithExpScope(scope,fileScope,d,explicitScopePart);
-        if (distance!=-1 && distance<minDistance)
-        {
-          minDistance = distance;
-          bestMatch = (MemberDef *)d;
-          //printf("new best match %s distance=%d\n",bestMatch->qualifiedName().data(),distance);
-        }
+        minDistance = distance;
+        bestMatch = (MemberDef *)d;
+        //printf("new best match %s distance=%d\n",bestMatch->qualifiedName().data(),distance);
       }
     }
   }
-  else if (di->definitionType()==Definition::TypeMember)
-  {
-    //printf("unique match!\n");
-    Definition *d = (Definition *)di;
-    g_visitedNamespaces.clear();
-    int distance = isAccessibleFromWithExpScope(scope,fileScope,d,explicitScopePart);
-    if (distance!=-1 && distance<minDistance)
-    {
-      minDistance = distance;
-      bestMatch = (MemberDef *)d;
-      //printf("new best match %s distance=%d\n",bestMatch->qualifiedName().data(),distance);
-    }
-  }
   return bestMatch;
 }
 
@@ -8382,3 +8695,129 @@ QCString getDotImageExtension(void)
   imgExt = imgExt.replace( QRegExp(":.*"), "" );
   return imgExt;
 }
+
+static QDict<QCString> *g_internPool = 0;
+static int g_internPoolSizeIndex = 0;
+
+/*! Returns a string with the same contents as \a s that shares its
+ *  (reference counted) data with all earlier results of this function
+ *  for the same contents. Use this for strings that are stored many
+ *  times over, like file names, member types and argument lists, so only
+ *  one copy of each is kept in memory. The pool is freed again by
+ *  freeInternedStrings().
+ */
+QCString internString(const char *s)
+{
+  if (s==0 || *s==0) return QCString();
+  // QCString stores strings of up to 2*sizeof(void*)-3 characters inside
+  // the object itself, so there is nothing to share for those
+  if (qstrlen(s)<=2*sizeof(void*)-3) return QCString(s);
+  if (g_internPool==0)
+  {
+    g_internPoolSizeIndex=9;
+    g_internPool = new QDict<QCString>(SDict_primes[g_internPoolSizeIndex]);
+    g_internPool->setAutoDelete(TRUE);
+  }
+  QCString *result = g_internPool->find(s);
+  if (result==0)
+  {
+    result = new QCString(s);
+    g_internPool->insert(s,result);
+    // auto resize if needed
+    if (g_internPool->count()>SDict_primes[g_internPoolSizeIndex])
+    {
+      g_internPool->resize(SDict_primes[++g_internPoolSizeIndex]);
+    }
+  }
+  return *result;
+}
+
+/*! Releases the pool used by internString(). Strings returned earlier
+ *  remain valid, they just no longer share data with later results.
+ */
+void freeInternedStrings()
+{
+  delete g_internPool;
+  g_internPool = 0;
+}
+
+/*! Checks if a file "baseName".md5 exists. If so the contents
+ *  are compared with \a md5. If equal FALSE is returned. If the .md5
+ *  file does not exist or its contents are not equal to \a md5, 
+ *  a new .md5 is generated with the \a md5 string as contents.
+ */
+bool checkAndUpdateMd5Signature(const QCString &baseName,
+            const QCString &md5)
+{
+  QFile f(baseName+".md5");
+  if (f.open(IO_ReadOnly))
+  {
+    // read checksum
+    QCString md5stored(33);
+    int bytesRead=f.readBlock(md5stored.rawData(),32);
+    md5stored[32]='\0';
+    // compare checksum
+    if (bytesRead==32 && md5==md5stored)
+    {
+      // bail out if equal
+      return FALSE;
+    }
+  }
+  f.close();
+  // create checksum file
+  if (f.open(IO_WriteOnly))
+  {
+    f.writeBlock(md5.data(),32); 
+    f.close();
+  }
+  return TRUE;
+}
+
+/*! Returns TRUE if \a file1 and, if given, \a file2 exist and are
+ *  not empty.
+ */
+bool checkDeliverables(const QCString &file1,const QCString &file2)
+{
+  bool file1Ok = TRUE;
+  bool file2Ok = TRUE;
+  if (!file1.isEmpty())
+  {
+    QFileInfo fi(file1);
+    file1Ok = (fi.exists() && fi.size()>0);
+  }
+  if (!file2.isEmpty())
+  {
+    QFileInfo fi(file2);
+    file2Ok = (fi.exists() && fi.size()>0);
+  }
+  return file1Ok && file2Ok;
+}
+
+/*! Returns the MD5 signature of the contents of file \a fileName
+ *  followed by \a extra, or an empty string if the file cannot be read.
+ *  Used to detect whether an external tool needs to run again for an
+ *  input file.
+ */
+QCString computeFileMd5(const QCString &fileName,const QCString &extra)
+{
+  QFile f(fileName);
+  if (!f.open(IO_ReadOnly)) return QCString();
+  struct MD5Context ctx;
+  MD5Init(&ctx);
+  char buf[4096];
+  int n;
+  while ((n=f.readBlock(buf,sizeof(buf)))>0)
+  {
+    MD5Update(&ctx,(md5byte const *)buf,n);
+  }
+  f.close();
+  if (!extra.isEmpty())
+  {
+    MD5Update(&ctx,(md5byte const *)extra.data(),extra.length());
+  }
+  uchar md5_sig[16];
+  QCString sigStr(33);
+  MD5Final(md5_sig,&ctx);
+  MD5SigToString(md5_sig,sigStr.rawData(),33);
+  return sigStr;
+}
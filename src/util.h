@@ -353,6 +353,12 @@ int isAccessibleFrom(Definition *scope,FileDef *fileScope,Definition *item);
 int isAccessibleFromWithExpScope(Definition *scope,FileDef *fileScope,Definition *item,
                      const QCString &explicitScopePart);
 
+void initAccessibilityCache(int size);
+
+void clearAccessibilityCache();
+
+void printAccessibilityCacheStats();
+
 int computeQualifiedIndex(const QCString &name);
 
 void addDirPrefix(QCString &fileName);
@@ -464,5 +470,12 @@ void convertProtectionLevel(
 
 bool mainPageHasTitle();
 
+QCString internString(const char *s);
+void freeInternedStrings();
+
+bool checkAndUpdateMd5Signature(const QCString &baseName,const QCString &md5);
+bool checkDeliverables(const QCString &file1,const QCString &file2=QCString());
+QCString computeFileMd5(const QCString &fileName,const QCString &extra=QCString());
+
 #endif
 
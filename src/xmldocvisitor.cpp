@@ -326,7 +326,7 @@ void XmlDocVisitor::visit(DocInclude *inc)
       Doxygen::parserManager->getParser(inc->extension())
                             ->parseCode(m_ci,
                                         inc->context(),
-                                        extractBlock(inc->text(),inc->blockId()),
+                                        inc->text(),
                                         langExt,
                                         inc->isExample(),
                                         inc->exampleFile()
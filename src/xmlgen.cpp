@@ -183,6 +183,57 @@ static void writeCombineScript()
 
 }
 
+/*! Writes the contents of all compound files listed in index.xml into a
+ *  single file all.xml, with the same result as running combine.xslt on
+ *  the index. The files are copied one at a time, so the combined output
+ *  is never kept in memory as a whole.
+ */
+static void writeCombinedOutput()
+{
+  QCString outputDirectory = Config_getString("XML_OUTPUT");
+  QFile fi(outputDirectory+"/index.xml");
+  if (!fi.open(IO_ReadOnly))
+  {
+    err("Cannot open file %s for reading!\n",fi.name().data());
+    return;
+  }
+  QCString fileName=outputDirectory+"/all.xml";
+  QFile fo(fileName);
+  if (!fo.open(IO_WriteOnly))
+  {
+    err("Cannot open file %s for writing!\n",fileName.data());
+    return;
+  }
+  FTextStream t(&fo);
+  t << "<?xml version=\"1.0\" standalone=\"yes\"?>" << endl;
+  t << "<doxygen version=\"" << versionString << "\">" << endl;
+
+  const int maxLineLen=4096;
+  char line[maxLineLen];
+  const char *prefix = "  <compound refid=\"";
+  const int prefixLen = qstrlen(prefix);
+  while (!fi.atEnd())
+  {
+    int numBytes = fi.readLine(line,maxLineLen);
+    if (numBytes<=0) break;
+    if (qstrncmp(line,prefix,prefixLen)!=0) continue;
+    const char *refid = line+prefixLen;
+    const char *end = strchr(refid,'"');
+    if (end==0) continue;
+    QCString compoundFile = outputDirectory+"/"+QCString(refid,end-refid+1)+".xml";
+    QCString contents = fileToString(compoundFile);
+    // strip the XML declaration and the <doxygen> start and end tags
+    int start = contents.find("<doxygen ");
+    if (start!=-1) start = contents.find('\n',start);
+    int stop  = contents.findRev("</doxygen>");
+    if (start!=-1 && stop>start)
+    {
+      t << contents.mid(start+1,stop-start-1);
+    }
+  }
+  t << "</doxygen>" << endl;
+}
+
 void writeXMLLink(FTextStream &t,const char *extRef,const char *compoundId,
                   const char *anchorId,const char *text,const char *tooltip)
 {
@@ -1981,8 +2032,14 @@ void generateXML()
 
   //t << "  </compoundlist>" << endl;
   t << "</doxygenindex>" << endl;
+  f.close();
 
   writeCombineScript();
+
+  if (Config_getBool("XML_COMBINED"))
+  {
+    writeCombinedOutput();
+  }
 }
 
 
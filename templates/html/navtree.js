@@ -424,8 +424,12 @@ function navTo(o,root,hash,relpath)
     hash=''; // strip line number anchors
   }
   var url=root+hash;
-  var i=-1;
-  while (NAVTREEINDEX[i+1]<=url) i++;
+  // binary search for the last sub-index whose first entry is <= url
+  var i=-1, lo=0, hi=NAVTREEINDEX.length-1;
+  while (lo<=hi) {
+    var mid=(lo+hi)>>1;
+    if (NAVTREEINDEX[mid]<=url) { i=mid; lo=mid+1; } else { hi=mid-1; }
+  }
   if (i==-1) { i=0; root=NAVTREE[0][1]; } // fallback: show index
   if (navTreeSubIndices[i]) {
     gotoNode(o,i,root,hash,relpath)